@@ -0,0 +1,146 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace utility {
+  // minimal lazy input range over a coroutine, stands in for std::generator
+  // which libc++ does not ship yet. Yielded values are stored by value, so
+  // yield views (spans, string_views) to hand out buffers without copies
+  template <typename T>
+  class Generator {
+   public:
+    struct promise_type {
+      T _value{};
+      std::exception_ptr _exception{};
+
+      Generator
+      get_return_object()
+      {
+        return Generator{
+            std::coroutine_handle<promise_type>::from_promise(*this)};
+      }
+      std::suspend_always
+      initial_suspend() noexcept
+      {
+        return {};
+      }
+      std::suspend_always
+      final_suspend() noexcept
+      {
+        return {};
+      }
+      std::suspend_always
+      yield_value(T value) noexcept
+      {
+        _value = std::move(value);
+        return {};
+      }
+      void
+      return_void() noexcept
+      {
+      }
+      void
+      unhandled_exception() noexcept
+      {
+        _exception = std::current_exception();
+      }
+    };
+
+    class Iterator {
+     public:
+      using value_type      = T;
+      using difference_type = std::ptrdiff_t;
+
+      Iterator() = default;
+      explicit Iterator(std::coroutine_handle<promise_type> handle)
+          : _handle{handle}
+      {
+      }
+
+      const T&
+      operator*() const
+      {
+        return _handle.promise()._value;
+      }
+      Iterator&
+      operator++()
+      {
+        resume(_handle);
+        return *this;
+      }
+      void
+      operator++(int)
+      {
+        ++*this;
+      }
+      bool
+      operator==(std::default_sentinel_t) const
+      {
+        return !_handle || _handle.done();
+      }
+
+     private:
+      std::coroutine_handle<promise_type> _handle{};
+    };
+
+    Generator(const Generator&) = delete;
+    Generator(Generator&& other) noexcept
+        : _handle{std::exchange(other._handle, {})}
+    {
+    }
+    Generator& operator=(const Generator&) = delete;
+    Generator&
+    operator=(Generator&& other) noexcept
+    {
+      if (this != &other) {
+        destroy();
+        _handle = std::exchange(other._handle, {});
+      }
+      return *this;
+    }
+    ~Generator() { destroy(); }
+
+    // single pass: begin() runs the body up to the first yield
+    Iterator
+    begin()
+    {
+      resume(_handle);
+      return Iterator{_handle};
+    }
+    std::default_sentinel_t
+    end() const
+    {
+      return {};
+    }
+
+   private:
+    explicit Generator(std::coroutine_handle<promise_type> handle)
+        : _handle{handle}
+    {
+    }
+
+    static void
+    resume(std::coroutine_handle<promise_type> handle)
+    {
+      if (!handle || handle.done()) {
+        return;
+      }
+      handle.resume();
+      if (auto exception = std::exchange(handle.promise()._exception, {})) {
+        std::rethrow_exception(exception);
+      }
+    }
+    void
+    destroy()
+    {
+      if (_handle) {
+        _handle.destroy();
+      }
+    }
+
+    std::coroutine_handle<promise_type> _handle{};
+  };
+}  // namespace utility
@@ -1,30 +1,64 @@
 #pragma once
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <barrier>
+#include <bit>
 #include <bitset>
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <expected>
+#include <functional>
 #include <limits>
+#include <mdspan>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <numeric>
 #include <queue>
+#include <ranges>
 #include <set>
 #include <span>
+#include <stdexcept>
 #include <string_view>
+#include <thread>
 #include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "generator.hpp"
+#include "spectral.hpp"
+
 namespace graph_first {
 
   using default_node_value_type = int16_t;
   struct ClustersFlag {};
+  struct ParallelFlag {};
+  struct MisraGriesFlag {};
 
   enum class GraphFlags : uint8_t {
     Weighted,
     Oriented,
   };
 
+  // which of the repeated edges deduplicateEdges keeps
+  enum class EdgeDedupPolicy : uint8_t {
+    KeepFirst,
+    KeepMinWeight,
+  };
+
+  // why rainbowShortestPath gave no path
+  enum class RainbowPathError : uint8_t {
+    NoPath,
+    VertexOutOfRange,
+    ColoursTooShort,
+    TooManyColours,
+  };
+
   namespace graph_flags {
     constexpr size_t kEmpty{};
 
@@ -38,6 +72,8 @@ namespace graph_first {
   struct EdgesListTag {};
   struct NodeListTag {};
   struct AdjacencyMatrixTag {};
+  struct CsrTag {};
+  struct BitMatrixTag {};
 
   template <size_t Nodeamount, size_t Flags, typename Valuetype,
             typename Containertag>
@@ -64,8 +100,131 @@ namespace graph_first {
               typename ContainerTag = AdjacencyMatrixTag>
     using WeightedOrientedGraph =
         Graph<NodeAmount, graph_flags::kFull, ValueType, ContainerTag>;
+
+    template <size_t NodeAmount, size_t GraphFlags = graph_flags::kEmpty>
+    using BitGraph = Graph<NodeAmount, GraphFlags, uint8_t, BitMatrixTag>;
   }  // namespace graph_types
 
+  struct PathStatistics {
+    double _averagePath{};
+    uint64_t _diameter{};
+    uint64_t _radius{};
+    std::vector<size_t> _center;
+  };
+
+  // eccentricities are bfs distances inside the vertex's own component
+  struct ExtremalDistances {
+    uint64_t _diameter{};
+    uint64_t _radius{};
+    std::vector<size_t> _center;
+  };
+
+  // component ids are numbered in order of their smallest vertex
+  struct ComponentLabels {
+    std::vector<size_t> _labels;
+    std::vector<size_t> _sizes;
+    size_t _giant{};
+  };
+
+  // degree of every vertex: sum over neighbours of max(a[i][j], a[j][i]), a
+  // loop counts once. This is the diagonal of getDegreeMatrix without the
+  // rest of the square
+  struct DegreeSequence {
+    std::vector<uint64_t> _degrees;
+
+    [[nodiscard]] size_t
+    size() const
+    {
+      return _degrees.size();
+    }
+    [[nodiscard]] uint64_t
+    operator[](size_t vertex) const
+    {
+      return _degrees[vertex];
+    }
+    [[nodiscard]] uint64_t
+    sum() const
+    {
+      return std::accumulate(_degrees.begin(), _degrees.end(), uint64_t{0});
+    }
+    [[nodiscard]] uint64_t
+    max() const
+    {
+      return _degrees.empty() ? 0 : *std::ranges::max_element(_degrees);
+    }
+    [[nodiscard]] double
+    average() const
+    {
+      return _degrees.empty() ? 0.0
+                              : static_cast<double>(sum()) /
+                                    static_cast<double>(_degrees.size());
+    }
+  };
+
+  // number of vertexes per degree, fed one degree at a time so that degrees
+  // of many sampled graphs can be collected without keeping them around
+  class DegreeHistogram {
+   public:
+    void
+    add(uint64_t degree)
+    {
+      if (degree >= _counts.size()) {
+        _counts.resize(degree + 1, 0);
+      }
+      ++_counts[degree];
+      ++_total;
+      _sum += degree;
+    }
+    void
+    add(const DegreeSequence& sequence)
+    {
+      for (uint64_t degree : sequence._degrees) {
+        add(degree);
+      }
+    }
+    void
+    merge(const DegreeHistogram& other)
+    {
+      if (other._counts.size() > _counts.size()) {
+        _counts.resize(other._counts.size(), 0);
+      }
+      for (size_t degree = 0; degree < other._counts.size(); ++degree) {
+        _counts[degree] += other._counts[degree];
+      }
+      _total += other._total;
+      _sum   += other._sum;
+    }
+
+    [[nodiscard]] size_t
+    count(uint64_t degree) const
+    {
+      return degree < _counts.size() ? _counts[degree] : 0;
+    }
+    // counts indexed by degree, up to the largest degree seen
+    [[nodiscard]] std::span<const size_t>
+    counts() const
+    {
+      return _counts;
+    }
+    [[nodiscard]] size_t
+    total() const
+    {
+      return _total;
+    }
+    [[nodiscard]] double
+    average() const
+    {
+      return _total == 0 ? 0.0
+                         : static_cast<double>(_sum) /
+                               static_cast<double>(_total);
+    }
+
+   private:
+    std::vector<size_t> _counts;
+    size_t _total{};
+    uint64_t _sum{};
+  };
+
   template <typename ValueType>
   struct EdgeEntry {
     size_t _startNode;
@@ -73,17 +232,548 @@ namespace graph_first {
     ValueType _value;
   };
 
+  // vector of trivially copyable values that keeps the first InlineCapacity
+  // elements inside the object and moves to the heap only past that
+  template <typename T, size_t InlineCapacity>
+  class SmallVector {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "SmallVector copies its elements bytewise");
+
+   public:
+    SmallVector() = default;
+    SmallVector(const SmallVector& other) { assign(other); }
+    SmallVector(SmallVector&& other) noexcept { steal(other); }
+    SmallVector&
+    operator=(const SmallVector& other)
+    {
+      if (this != &other) {
+        _size = 0;
+        assign(other);
+      }
+      return *this;
+    }
+    SmallVector&
+    operator=(SmallVector&& other) noexcept
+    {
+      if (this != &other) {
+        release();
+        steal(other);
+      }
+      return *this;
+    }
+    ~SmallVector() { release(); }
+
+    void
+    push_back(const T& value)
+    {
+      if (_size == _capacity) {
+        reserve(_capacity * 2);
+      }
+      _data[_size++] = value;
+    }
+    void
+    reserve(size_t capacity)
+    {
+      if (capacity <= _capacity) {
+        return;
+      }
+      T* data = std::allocator<T>{}.allocate(capacity);
+      std::copy(_data, _data + _size, data);
+      release();
+      _data     = data;
+      _capacity = capacity;
+    }
+    // drops the tail, capacity is kept
+    void
+    truncate(size_t size)
+    {
+      _size = std::min(_size, size);
+    }
+
+    [[nodiscard]] size_t
+    size() const
+    {
+      return _size;
+    }
+    [[nodiscard]] bool
+    empty() const
+    {
+      return _size == 0;
+    }
+    T&
+    operator[](size_t idx)
+    {
+      return _data[idx];
+    }
+    const T&
+    operator[](size_t idx) const
+    {
+      return _data[idx];
+    }
+    T*
+    begin()
+    {
+      return _data;
+    }
+    T*
+    end()
+    {
+      return _data + _size;
+    }
+    const T*
+    begin() const
+    {
+      return _data;
+    }
+    const T*
+    end() const
+    {
+      return _data + _size;
+    }
+
+   private:
+    [[nodiscard]] bool
+    isInline() const
+    {
+      return _data == _inline.data();
+    }
+    void
+    release()
+    {
+      if (!isInline()) {
+        std::allocator<T>{}.deallocate(_data, _capacity);
+      }
+      _data     = _inline.data();
+      _capacity = InlineCapacity;
+    }
+    void
+    assign(const SmallVector& other)
+    {
+      reserve(other._size);
+      std::copy(other.begin(), other.end(), _data);
+      _size = other._size;
+    }
+    void
+    steal(SmallVector& other)
+    {
+      if (other.isInline()) {
+        std::copy(other.begin(), other.end(), _inline.data());
+      }
+      else {
+        _data     = other._data;
+        _capacity = other._capacity;
+      }
+      _size = other._size;
+      other._data     = other._inline.data();
+      other._size     = 0;
+      other._capacity = InlineCapacity;
+    }
+
+    T* _data{_inline.data()};
+    size_t _size{};
+    size_t _capacity{InlineCapacity};
+    std::array<T, InlineCapacity> _inline{};
+  };
+
   template <typename ValueType>
-  struct NodeEntry {
-    size_t _idx{};
-    std::string _name;
-    std::vector<size_t> _neighbours;
-    std::vector<std::pair<size_t, ValueType>> _edges;
+  struct NodeEdge {
+    size_t _node;
+    ValueType _value;
+  };
+
+  // structure of arrays node list: every field of a node lives in its own
+  // column, names share one arena. Inserts append, rows touched since the
+  // last normalize() are sorted and deduplicated in one pass by it. Like
+  // other lazy indexes it is not thread safe while rows are dirty, Graph
+  // normalizes it before it spawns workers
+  template <typename ValueType, size_t N = 0>
+  class NodeStore {
+   public:
+    static constexpr size_t kInlineNeighbours{4};
+
+    using NeighbourRow = SmallVector<size_t, kInlineNeighbours>;
+    using EdgeRow      = SmallVector<NodeEdge<ValueType>, kInlineNeighbours>;
+
+    NodeStore()
+    {
+      for (size_t i = 0; i < N; ++i) {
+        addNode(i, {});
+      }
+    }
+
+    [[nodiscard]] size_t
+    size() const
+    {
+      return _ids.size();
+    }
+    void
+    addNode(size_t idx, std::string_view name)
+    {
+      _ids.push_back(idx);
+      _name_spans.emplace_back(_names.size(), name.size());
+      _names.append(name);
+      _neighbours.emplace_back();
+      _edges.emplace_back();
+      _dirty.push_back(false);
+    }
+    void
+    setName(size_t node, std::string_view name)
+    {
+      _name_spans[node] = {_names.size(), name.size()};
+      _names.append(name);
+    }
+    // a repeated edge keeps the last value
+    void
+    addEdge(size_t first_node, size_t second_node, ValueType value)
+    {
+      _edges[first_node].push_back({second_node, value});
+      markDirty(first_node);
+      if (first_node != second_node) {
+        _neighbours[first_node].push_back(second_node);
+        _neighbours[second_node].push_back(first_node);
+        markDirty(second_node);
+      }
+    }
+    [[nodiscard]] bool
+    dirty() const
+    {
+      return !_dirty_nodes.empty();
+    }
+    // a no-op without writes when nothing is dirty, so concurrent readers of
+    // a normalized store don't race
+    void
+    normalize() const
+    {
+      if (_dirty_nodes.empty()) {
+        return;
+      }
+      for (size_t node : _dirty_nodes) {
+        auto& neighbours = _neighbours[node];
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.truncate(static_cast<size_t>(
+            std::unique(neighbours.begin(), neighbours.end()) -
+            neighbours.begin()));
+
+        auto& edges = _edges[node];
+        std::stable_sort(edges.begin(), edges.end(),
+                         [](const auto& a, const auto& b) {
+                           return a._node < b._node;
+                         });
+        size_t kept{};
+        for (size_t i = 0; i < edges.size(); ++i) {
+          if (i + 1 < edges.size() && edges[i + 1]._node == edges[i]._node) {
+            continue;
+          }
+          edges[kept++] = edges[i];
+        }
+        edges.truncate(kept);
+        _dirty[node] = false;
+      }
+      _dirty_nodes.clear();
+    }
+
+    [[nodiscard]] size_t
+    id(size_t node) const
+    {
+      return _ids[node];
+    }
+    [[nodiscard]] std::string_view
+    name(size_t node) const
+    {
+      return std::string_view{_names}.substr(_name_spans[node].first,
+                                             _name_spans[node].second);
+    }
+    [[nodiscard]] std::span<const size_t>
+    neighbours(size_t node) const
+    {
+      return {_neighbours[node].begin(), _neighbours[node].end()};
+    }
+    [[nodiscard]] std::span<const NodeEdge<ValueType>>
+    edges(size_t node) const
+    {
+      return {_edges[node].begin(), _edges[node].end()};
+    }
+    // binary search, valid on normalized rows only
+    [[nodiscard]] const NodeEdge<ValueType>*
+    findEdge(size_t first_node, size_t second_node) const
+    {
+      auto row = edges(first_node);
+      auto it  = std::ranges::lower_bound(row, second_node, {},
+                                          &NodeEdge<ValueType>::_node);
+      return it == row.end() || it->_node != second_node ? nullptr : &*it;
+    }
+
+   private:
+    void
+    markDirty(size_t node)
+    {
+      if (!_dirty[node]) {
+        _dirty[node] = true;
+        _dirty_nodes.push_back(node);
+      }
+    }
+
+    std::vector<size_t> _ids;
+    std::vector<std::pair<size_t, size_t>> _name_spans;
+    std::string _names;
+    mutable std::vector<NeighbourRow> _neighbours;
+    mutable std::vector<EdgeRow> _edges;
+    mutable std::vector<bool> _dirty;
+    mutable std::vector<size_t> _dirty_nodes;
   };
 
   template <typename ValueType>
   using AdjacencyListEntry = std::pair<size_t, ValueType>;
 
+  // row i occupies [_offsets[i], _offsets[i + 1]) of _neighbours/_values,
+  // neighbours inside a row are sorted
+  template <typename ValueType>
+  struct CsrStorage {
+    std::vector<size_t> _offsets;
+    std::vector<size_t> _neighbours;
+    std::vector<ValueType> _values;
+
+    [[nodiscard]] size_t
+    size() const
+    {
+      return _offsets.empty() ? 0 : _offsets.size() - 1;
+    }
+    [[nodiscard]] std::span<const size_t>
+    neighbours(size_t vertex) const
+    {
+      return std::span<const size_t>{_neighbours}.subspan(
+          _offsets[vertex], _offsets[vertex + 1] - _offsets[vertex]);
+    }
+    [[nodiscard]] std::span<const ValueType>
+    values(size_t vertex) const
+    {
+      return std::span<const ValueType>{_values}.subspan(
+          _offsets[vertex], _offsets[vertex + 1] - _offsets[vertex]);
+    }
+  };
+
+  struct EdgeKeyHash {
+    size_t
+    operator()(const std::pair<size_t, size_t>& key) const noexcept
+    {
+      // fibonacci multiplier spreads the first endpoint over the high bits
+      return std::hash<size_t>{}(key.first * 0x9E3779B97F4A7C15ULL ^
+                                 key.second);
+    }
+  };
+
+  // edge ids of an edges list grouped by start and by end vertex, ids inside
+  // a group keep the order of the list
+  struct EdgeIncidence {
+    std::vector<size_t> _out_offsets;
+    std::vector<size_t> _out_edges;
+    std::vector<size_t> _in_offsets;
+    std::vector<size_t> _in_edges;
+    bool _valid{false};
+
+    [[nodiscard]] size_t
+    size() const
+    {
+      return _out_offsets.empty() ? 0 : _out_offsets.size() - 1;
+    }
+    [[nodiscard]] std::span<const size_t>
+    outEdges(size_t vertex) const
+    {
+      return group(_out_offsets, _out_edges, vertex);
+    }
+    [[nodiscard]] std::span<const size_t>
+    inEdges(size_t vertex) const
+    {
+      return group(_in_offsets, _in_edges, vertex);
+    }
+
+    template <typename Edges>
+    void
+    build(const Edges& edges)
+    {
+      size_t vertex_count{};
+      for (const auto& edge : edges) {
+        vertex_count =
+            std::max({vertex_count, edge._startNode + 1, edge._endNode + 1});
+      }
+      _out_offsets.assign(vertex_count + 1, 0);
+      _in_offsets.assign(vertex_count + 1, 0);
+      for (const auto& edge : edges) {
+        _out_offsets[edge._startNode + 1]++;
+        _in_offsets[edge._endNode + 1]++;
+      }
+      std::partial_sum(_out_offsets.begin(), _out_offsets.end(),
+                       _out_offsets.begin());
+      std::partial_sum(_in_offsets.begin(), _in_offsets.end(),
+                       _in_offsets.begin());
+
+      _out_edges.resize(_out_offsets.back());
+      _in_edges.resize(_in_offsets.back());
+      std::vector<size_t> out_position(_out_offsets.begin(),
+                                       _out_offsets.end() - 1);
+      std::vector<size_t> in_position(_in_offsets.begin(),
+                                      _in_offsets.end() - 1);
+      size_t id{};
+      for (const auto& edge : edges) {
+        _out_edges[out_position[edge._startNode]++] = id;
+        _in_edges[in_position[edge._endNode]++]     = id;
+        ++id;
+      }
+      _valid = true;
+    }
+
+   private:
+    [[nodiscard]] static std::span<const size_t>
+    group(const std::vector<size_t>& offsets, const std::vector<size_t>& ids,
+          size_t vertex)
+    {
+      if (vertex + 1 >= offsets.size()) {
+        return {};
+      }
+      return std::span<const size_t>{ids}.subspan(
+          offsets[vertex], offsets[vertex + 1] - offsets[vertex]);
+    }
+  };
+
+  // in-neighbours of an adjacency list, grouped by the vertex they point to
+  // and increasing inside a group. Entries with a zero value are skipped
+  struct ReverseAdjacency {
+    std::vector<size_t> _offsets;
+    std::vector<size_t> _sources;
+    bool _valid{false};
+
+    [[nodiscard]] std::span<const size_t>
+    sources(size_t vertex) const
+    {
+      if (vertex + 1 >= _offsets.size()) {
+        return {};
+      }
+      return std::span<const size_t>{_sources}.subspan(
+          _offsets[vertex], _offsets[vertex + 1] - _offsets[vertex]);
+    }
+
+    template <typename Rows>
+    void
+    build(const Rows& rows)
+    {
+      _offsets.assign(rows.size() + 1, 0);
+      for (const auto& row : rows) {
+        for (const auto& [neighbour, value] : row) {
+          if (value != 0) {
+            _offsets[neighbour + 1]++;
+          }
+        }
+      }
+      std::partial_sum(_offsets.begin(), _offsets.end(), _offsets.begin());
+
+      _sources.resize(_offsets.back());
+      std::vector<size_t> position(_offsets.begin(), _offsets.end() - 1);
+      for (size_t i = 0; i < rows.size(); ++i) {
+        for (const auto& [neighbour, value] : rows[i]) {
+          if (value != 0) {
+            _sources[position[neighbour]++] = i;
+          }
+        }
+      }
+      _valid = true;
+    }
+  };
+
+  // incidence matrix with one column per edge, -1 at the start vertex and +1
+  // at the end; a loop keeps only its +1. Columns are csc with at most two
+  // entries each, rows hold the same entries in csr order with edge ids
+  // increasing
+  struct SparseIncidenceMatrix {
+    std::vector<size_t> _column_offsets{0};
+    std::vector<size_t> _column_rows;
+    std::vector<int8_t> _column_values;
+    std::vector<size_t> _row_offsets;
+    std::vector<size_t> _row_columns;
+    std::vector<int8_t> _row_values;
+
+    [[nodiscard]] size_t
+    rows() const
+    {
+      return _row_offsets.empty() ? 0 : _row_offsets.size() - 1;
+    }
+    [[nodiscard]] size_t
+    columns() const
+    {
+      return _column_offsets.size() - 1;
+    }
+    // vertexes of edge, in increasing order
+    [[nodiscard]] std::span<const size_t>
+    column(size_t edge) const
+    {
+      return std::span<const size_t>{_column_rows}.subspan(
+          _column_offsets[edge],
+          _column_offsets[edge + 1] - _column_offsets[edge]);
+    }
+    [[nodiscard]] std::span<const int8_t>
+    columnValues(size_t edge) const
+    {
+      return std::span<const int8_t>{_column_values}.subspan(
+          _column_offsets[edge],
+          _column_offsets[edge + 1] - _column_offsets[edge]);
+    }
+    // edges at vertex
+    [[nodiscard]] std::span<const size_t>
+    row(size_t vertex) const
+    {
+      return std::span<const size_t>{_row_columns}.subspan(
+          _row_offsets[vertex],
+          _row_offsets[vertex + 1] - _row_offsets[vertex]);
+    }
+    [[nodiscard]] std::span<const int8_t>
+    rowValues(size_t vertex) const
+    {
+      return std::span<const int8_t>{_row_values}.subspan(
+          _row_offsets[vertex],
+          _row_offsets[vertex + 1] - _row_offsets[vertex]);
+    }
+
+    void
+    addEdge(size_t start, size_t end)
+    {
+      if (start != end) {
+        auto [low, high] = std::minmax(start, end);
+        _column_rows.push_back(low);
+        _column_values.push_back(low == start ? -1 : 1);
+        _column_rows.push_back(high);
+        _column_values.push_back(high == start ? -1 : 1);
+      }
+      else {
+        _column_rows.push_back(end);
+        _column_values.push_back(1);
+      }
+      _column_offsets.push_back(_column_rows.size());
+    }
+    // counting sort of the column entries by vertex
+    void
+    buildRows(size_t vertex_count)
+    {
+      _row_offsets.assign(vertex_count + 1, 0);
+      for (size_t vertex : _column_rows) {
+        _row_offsets[vertex + 1]++;
+      }
+      std::partial_sum(_row_offsets.begin(), _row_offsets.end(),
+                       _row_offsets.begin());
+
+      _row_columns.resize(_column_rows.size());
+      _row_values.resize(_column_rows.size());
+      std::vector<size_t> position(_row_offsets.begin(),
+                                   _row_offsets.end() - 1);
+      for (size_t edge = 0; edge < columns(); ++edge) {
+        for (size_t k = _column_offsets[edge]; k < _column_offsets[edge + 1];
+             ++k) {
+          size_t slot        = position[_column_rows[k]]++;
+          _row_columns[slot] = edge;
+          _row_values[slot]  = _column_values[k];
+        }
+      }
+    }
+  };
+
   //===========================
   template <bool IsWeighted, typename ValueType, size_t N,
             typename ContainerTag = AdjacencyMatrixTag>
@@ -93,12 +783,15 @@ namespace graph_first {
     using NamesContainer = std::array<std::string, N>;
   };
 
+  template <typename ValueType>
+  class FlatMatrix;
+
   template <bool IsWeighted, typename ValueType>
   class GraphContainerTrait<IsWeighted, ValueType,
                             graph_types::kNodeAmountResizable,
                             AdjacencyMatrixTag> {
    protected:
-    using Container      = std::vector<std::vector<ValueType>>;
+    using Container      = FlatMatrix<ValueType>;
     using NamesContainer = std::vector<std::string>;
   };
 
@@ -136,7 +829,7 @@ namespace graph_first {
   template <bool IsWeighted, typename ValueType, size_t N>
   class GraphContainerTrait<IsWeighted, ValueType, N, NodeListTag> {
    protected:
-    using Container      = std::array<NodeEntry<ValueType>, N>;
+    using Container      = NodeStore<ValueType, N>;
     using NamesContainer = bool;
   };
 
@@ -144,17 +837,430 @@ namespace graph_first {
   class GraphContainerTrait<IsWeighted, ValueType,
                             graph_types::kNodeAmountResizable, NodeListTag> {
    protected:
-    using Container      = std::vector<NodeEntry<ValueType>>;
+    using Container      = NodeStore<ValueType>;
     using NamesContainer = bool;
   };
 
-  template <bool IsOriented, typename ValueType, size_t NodeAmount>
-  class IncidenceMatrixType {};
+  // one bit per cell, every row is padded to whole words so rows can be
+  // combined word by word
+  template <size_t N>
+  class BitMatrix {
+   public:
+    using word_type                     = uint64_t;
+    static constexpr size_t kWordBits   = std::numeric_limits<word_type>::digits;
+    static constexpr size_t kStaticWords = (N + kWordBits - 1) / kWordBits;
+
+    class BitReference {
+     public:
+      BitReference(word_type& word, word_type mask) : _word(word), _mask(mask)
+      {
+      }
+      BitReference&
+      operator=(bool value)
+      {
+        _word = value ? (_word | _mask) : (_word & ~_mask);
+        return *this;
+      }
+      operator bool() const  // NOLINT(google-explicit-constructor)
+      {
+        return (_word & _mask) != 0;
+      }
 
-  template <typename ValueType, size_t NodeAmount>
-  class IncidenceMatrixType<true, ValueType, NodeAmount> {
-   protected:
-    using IncidenceMatrix = std::array<std::vector<ValueType>, NodeAmount>;
+     private:
+      word_type& _word;
+      word_type _mask;
+    };
+
+    template <bool IsConst>
+    class RowReference {
+     public:
+      using words_type =
+          std::conditional_t<IsConst, const word_type, word_type>;
+
+      RowReference(std::span<words_type> words, size_t size) :
+          _words(words), _size(size)
+      {
+      }
+      auto
+      operator[](size_t idx) const
+      {
+        word_type mask = word_type{1} << (idx % kWordBits);
+        if constexpr (IsConst) {
+          return (_words[idx / kWordBits] & mask) != 0;
+        }
+        else {
+          return BitReference{_words[idx / kWordBits], mask};
+        }
+      }
+      [[nodiscard]] size_t
+      size() const
+      {
+        return _size;
+      }
+      [[nodiscard]] std::span<words_type>
+      words() const
+      {
+        return _words;
+      }
+
+     private:
+      std::span<words_type> _words;
+      size_t _size;
+    };
+
+    [[nodiscard]] size_t
+    size() const
+    {
+      if constexpr (N != 0) {
+        return N;
+      }
+      else {
+        return _size;
+      }
+    }
+    [[nodiscard]] size_t
+    rowWords() const
+    {
+      return (size() + kWordBits - 1) / kWordBits;
+    }
+
+    void
+    resize(size_t size_new)
+    {
+      static_assert(N == 0, "Not resizable");
+      BitMatrix result{};
+      result._size = size_new;
+      result._data.resize(size_new * result.rowWords());
+      size_t common = std::min(size_new, _size);
+      for (size_t i = 0; i < common; ++i) {
+        auto from = (*this)[i].words();
+        auto to   = result[i].words();
+        std::copy_n(from.begin(), std::min(from.size(), to.size()), to.begin());
+        if (size_new < _size && !to.empty() && size_new % kWordBits != 0) {
+          to.back() &= (word_type{1} << (size_new % kWordBits)) - 1;
+        }
+      }
+      *this = std::move(result);
+    }
+
+    RowReference<false>
+    operator[](size_t idx)
+    {
+      return {std::span<word_type>{_data}.subspan(idx * rowWords(), rowWords()),
+              size()};
+    }
+    RowReference<true>
+    operator[](size_t idx) const
+    {
+      return {std::span<const word_type>{_data}.subspan(idx * rowWords(),
+                                                        rowWords()),
+              size()};
+    }
+
+    // calls function(column) for every set bit of the row
+    template <typename Function>
+    void
+    forEachSet(size_t row, Function&& function) const
+    {
+      auto words = (*this)[row].words();
+      for (size_t w = 0; w < words.size(); ++w) {
+        for (word_type bits = words[w]; bits != 0; bits &= bits - 1) {
+          function((w * kWordBits) + static_cast<size_t>(std::countr_zero(bits)));
+        }
+      }
+    }
+
+    [[nodiscard]] BitMatrix
+    transposed() const
+    {
+      BitMatrix result{};
+      if constexpr (N == 0) {
+        result.resize(size());
+      }
+      for (size_t i = 0; i < size(); ++i) {
+        forEachSet(i, [&result, i](size_t j) { result[j][i] = true; });
+      }
+      return result;
+    }
+
+   private:
+    std::conditional_t<N == 0, std::vector<word_type>,
+                       std::array<word_type, N * kStaticWords>>
+        _data{};
+    size_t _size{};
+  };
+
+  // square matrix in one 64-byte aligned buffer, rows are _stride apart so
+  // every row starts on a cache line. Capacity grows geometrically and cells
+  // outside size() x size() are kept zero
+  template <typename ValueType>
+  class FlatMatrix {
+    static_assert(std::is_trivially_copyable_v<ValueType>,
+                  "FlatMatrix stores trivially copyable values only");
+
+   public:
+    static constexpr size_t kAlignment{64};
+    static constexpr size_t kRowAlignment{
+        std::max<size_t>(1, kAlignment / sizeof(ValueType))};
+
+    template <bool IsConst>
+    class RowIterator {
+     public:
+      using value_type =
+          std::span<std::conditional_t<IsConst, const ValueType, ValueType>>;
+      using difference_type = std::ptrdiff_t;
+      using matrix_type =
+          std::conditional_t<IsConst, const FlatMatrix, FlatMatrix>;
+
+      RowIterator() = default;
+      RowIterator(matrix_type* matrix, size_t row) : _matrix(matrix), _row(row)
+      {
+      }
+
+      value_type
+      operator*() const
+      {
+        return (*_matrix)[_row];
+      }
+      RowIterator&
+      operator++()
+      {
+        ++_row;
+        return *this;
+      }
+      RowIterator
+      operator++(int)
+      {
+        auto copy = *this;
+        ++_row;
+        return copy;
+      }
+      bool
+      operator==(const RowIterator& other) const
+      {
+        return _row == other._row;
+      }
+
+     private:
+      matrix_type* _matrix{};
+      size_t _row{};
+    };
+
+    FlatMatrix() = default;
+    FlatMatrix(const FlatMatrix& other) :
+        _data(allocate(other._stride)),
+        _size(other._size),
+        _stride(other._stride)
+    {
+      std::copy_n(other._data.get(), _stride * _stride, _data.get());
+    }
+    FlatMatrix(FlatMatrix&& other) noexcept :
+        _data(std::move(other._data)),
+        _size(std::exchange(other._size, 0)),
+        _stride(std::exchange(other._stride, 0))
+    {
+    }
+    FlatMatrix&
+    operator=(const FlatMatrix& other)
+    {
+      if (this != &other) {
+        *this = FlatMatrix(other);
+      }
+      return *this;
+    }
+    FlatMatrix&
+    operator=(FlatMatrix&& other) noexcept
+    {
+      _data   = std::move(other._data);
+      _size   = std::exchange(other._size, 0);
+      _stride = std::exchange(other._stride, 0);
+      return *this;
+    }
+    ~FlatMatrix() = default;
+
+    [[nodiscard]] size_t
+    size() const
+    {
+      return _size;
+    }
+    [[nodiscard]] size_t
+    stride() const
+    {
+      return _stride;
+    }
+
+    void
+    resize(size_t size_new)
+    {
+      if (size_new > _stride) {
+        size_t stride_new = std::max(size_new, _stride * 2);
+        stride_new        = (stride_new + kRowAlignment - 1) / kRowAlignment *
+                     kRowAlignment;
+        auto data_new = allocate(stride_new);
+        for (size_t i = 0; i < _size; ++i) {
+          std::copy_n(_data.get() + (i * _stride), _size,
+                      data_new.get() + (i * stride_new));
+        }
+        _data   = std::move(data_new);
+        _stride = stride_new;
+      }
+      for (size_t i = size_new; i < _size; ++i) {
+        std::fill_n(_data.get() + (i * _stride), _size, ValueType{});
+      }
+      for (size_t i = 0; size_new < _size && i < size_new; ++i) {
+        std::fill(_data.get() + (i * _stride) + size_new,
+                  _data.get() + (i * _stride) + _size, ValueType{});
+      }
+      _size = size_new;
+    }
+
+    // drops row and column index, later rows and columns move one step back
+    void
+    erase(size_t index)
+    {
+      for (size_t i = 0; i < _size; ++i) {
+        ValueType* row = _data.get() + (i * _stride);
+        if (i > index) {
+          std::copy_n(row, _size, row - _stride);
+        }
+      }
+      for (size_t i = 0; i + 1 < _size; ++i) {
+        ValueType* row = _data.get() + (i * _stride);
+        std::copy(row + index + 1, row + _size, row + index);
+      }
+      resize(_size - 1);
+    }
+
+    // moves the last row and column into index, O(size())
+    void
+    swapErase(size_t index)
+    {
+      size_t last = _size - 1;
+      if (index != last) {
+        std::copy_n(_data.get() + (last * _stride), _size,
+                    _data.get() + (index * _stride));
+        for (size_t i = 0; i < last; ++i) {
+          ValueType* row = _data.get() + (i * _stride);
+          row[index]     = row[last];
+        }
+      }
+      resize(last);
+    }
+
+    // keeps rows and columns listed in ascending kept, one in-place pass:
+    // every cell only moves towards the front
+    void
+    compact(std::span<const size_t> kept)
+    {
+      for (size_t i = 0; i < kept.size(); ++i) {
+        const ValueType* from = _data.get() + (kept[i] * _stride);
+        ValueType* to         = _data.get() + (i * _stride);
+        for (size_t j = 0; j < kept.size(); ++j) {
+          to[j] = from[kept[j]];
+        }
+      }
+      resize(kept.size());
+    }
+
+    std::span<ValueType>
+    operator[](size_t row)
+    {
+      return {_data.get() + (row * _stride), _size};
+    }
+    std::span<const ValueType>
+    operator[](size_t row) const
+    {
+      return {_data.get() + (row * _stride), _size};
+    }
+
+    auto
+    data()
+    {
+      return std::mdspan(
+          _data.get(),
+          std::layout_stride::mapping{std::dextents<size_t, 2>{_size, _size},
+                                      std::array<size_t, 2>{_stride, 1}});
+    }
+    auto
+    data() const
+    {
+      return std::mdspan(
+          static_cast<const ValueType*>(_data.get()),
+          std::layout_stride::mapping{std::dextents<size_t, 2>{_size, _size},
+                                      std::array<size_t, 2>{_stride, 1}});
+    }
+
+    RowIterator<false>
+    begin()
+    {
+      return {this, 0};
+    }
+    RowIterator<false>
+    end()
+    {
+      return {this, _size};
+    }
+    RowIterator<true>
+    begin() const
+    {
+      return {this, 0};
+    }
+    RowIterator<true>
+    end() const
+    {
+      return {this, _size};
+    }
+
+   private:
+    struct AlignedDelete {
+      void
+      operator()(ValueType* pointer) const
+      {
+        ::operator delete[](pointer, std::align_val_t{kAlignment});
+      }
+    };
+    using Buffer = std::unique_ptr<ValueType[], AlignedDelete>;
+
+    static Buffer
+    allocate(size_t stride)
+    {
+      if (stride == 0) {
+        return Buffer{};
+      }
+      Buffer buffer{static_cast<ValueType*>(::operator new[](
+          stride * stride * sizeof(ValueType), std::align_val_t{kAlignment}))};
+      std::fill_n(buffer.get(), stride * stride, ValueType{});
+      return buffer;
+    }
+
+    Buffer _data{};
+    size_t _size{};
+    size_t _stride{};
+  };
+
+  template <bool IsWeighted, typename ValueType, size_t N>
+  class GraphContainerTrait<IsWeighted, ValueType, N, BitMatrixTag> {
+   protected:
+    static_assert(!IsWeighted, "BitMatrixTag stores unweighted graphs only");
+    using Container      = BitMatrix<N>;
+    using NamesContainer = std::conditional_t<N == 0, std::vector<std::string>,
+                                              std::array<std::string, N>>;
+  };
+
+  template <bool IsWeighted, typename ValueType, size_t N>
+  class GraphContainerTrait<IsWeighted, ValueType, N, CsrTag> {
+   protected:
+    using Container      = CsrStorage<ValueType>;
+    using NamesContainer = std::vector<std::string>;
+  };
+
+  template <bool IsOriented, typename ValueType, size_t NodeAmount>
+  class IncidenceMatrixType {};
+
+  template <typename ValueType, size_t NodeAmount>
+  class IncidenceMatrixType<true, ValueType, NodeAmount> {
+   protected:
+    using IncidenceMatrix = std::array<std::vector<ValueType>, NodeAmount>;
   };
 
   template <typename ValueType, size_t NodeAmount>
@@ -239,6 +1345,8 @@ namespace graph_first {
     static constexpr bool kIsWeighted{(Flags & graph_flags::kWeighted) != 0U};
     static constexpr bool kResizable{NodeAmount ==
                                      graph_types::kNodeAmountResizable};
+    static constexpr bool kIsBitMatrix{
+        std::is_same_v<ContainerTag, BitMatrixTag>};
 
    public:
     using signed_value_type   = std::make_signed_t<ValueType>;
@@ -254,6 +1362,10 @@ namespace graph_first {
     using DistanceMatrix      = traits::DistanceMatrix;
     using KirchoffMatrix      = traits::KirchoffMatrix;
 
+    static constexpr uint64_t kUnreachable =
+        std::numeric_limits<uint64_t>::max();
+    static constexpr size_t kBfsBatch{std::numeric_limits<uint64_t>::digits};
+
     template <typename ContainerType = ContainerTag>
     void
     addEdgeImpl(size_t firstNode, size_t secondNode, ValueType value = 1)
@@ -264,66 +1376,28 @@ namespace graph_first {
       }
     }
 
-    /*
     template <>
     void
     addEdgeImpl<AdjacencyListTag>(size_t firstNode, size_t secondNode,
-                                  ValueType value = 1)
+                                  ValueType value)
     {
-      if (_matrix[firstNode].size() == 0 ||
-          _matrix[firstNode][_matrix.size() - 1] != 0) {
-        _matrix[firstNode].emplace_back();
+      if constexpr (kResizable) {
+        if (std::max(firstNode, secondNode) >= _matrix.size()) {
+          _matrix.resize(std::max(firstNode, secondNode) + 1);
+        }
       }
-
-      auto result = std::ranges::find(
-          _matrix[firstNode], [](auto& value) { return value.first == 0; });
-      result->first            = secondNode;
-      result->second           = value;
-
-      _matrix[firstNode].first = firstNode;
+      insertAdjacencyEntry(firstNode, secondNode, value);
       if constexpr (!kIsOriented) {
-        if (_matrix[secondNode].size() == 0 ||
-            _matrix[secondNode][_matrix.size() - 1] != 0) {
-          _matrix[secondNode].emplace_back();
-        }
-        result = std::ranges::find(
-            _matrix[secondNode], [](auto& value) { return value.first == 0; });
-        result->first  = firstNode;
-        result->second = value;
+        insertAdjacencyEntry(secondNode, firstNode, value);
       }
     }
 
-
-     * */
-
     template <>
     void
     addEdgeImpl<NodeListTag>(size_t firstNode, size_t secondNode,
                              ValueType value)
     {
-      _matrix[firstNode]._edges.emplace_back(secondNode, value);
-
-      bool check = {false};
-      for (auto& neh : _matrix[firstNode]._neighbours) {
-        if (neh == secondNode) {
-          check = true;
-          break;
-        }
-      }
-      if (!check && _matrix[firstNode]._idx != secondNode) {
-        _matrix[firstNode]._neighbours.emplace_back(secondNode);
-      }
-      check = false;
-      for (auto& neh : _matrix[secondNode]._neighbours) {
-        if (neh == secondNode) {
-          check = true;
-          break;
-        }
-      }
-      if (!check && _matrix[secondNode]._idx != firstNode) {
-        _matrix[secondNode]._neighbours.emplace_back(firstNode);
-      }
-      // need to add for not-oriented
+      _matrix.addEdge(firstNode, secondNode, value);
     }
 
     template <>
@@ -333,6 +1407,7 @@ namespace graph_first {
     {
       if constexpr (kResizable) {
         _matrix.push_back({firstNode, secondNode, value});
+        _incidence._valid = false;
         return;
       }
     }
@@ -351,141 +1426,426 @@ namespace graph_first {
     }*/
       addEdgeImpl(firstNode, secondNode, value);
     }
-    std::vector<size_t>
-    colorVertexes(const DegreeMatrix& degrees)
-    {
-      std::set<size_t> vertexes;
-      std::ranges::for_each(_matrix, [&vertexes](auto& edges) {
-        vertexes.insert(edges._startNode);
-        vertexes.insert(edges._endNode);
-      });
 
-      std::vector<size_t> result_colours(vertexes.size());
-      std::vector<bool> coloured(vertexes.size(), false);
+    // builds CsrTag graph from an edges list or a dense matrix graph with the
+    // same flags, source is read once
+    template <size_t SourceNodeAmount, typename SourceTag>
+    static Graph
+    fromGraph(
+        const Graph<SourceNodeAmount, Flags, ValueType, SourceTag>& source)
+    {
+      static_assert(std::is_same_v<ContainerTag, CsrTag>,
+                    "Only CsrTag graphs are built from other graphs");
+      Graph result{};
+      auto& csr          = result._matrix;
+      const auto& matrix = source.getCmatrix();
+
+      if constexpr (std::is_same_v<SourceTag, EdgesListTag>) {
+        size_t vertex_count{};
+        for (const auto& edge : matrix) {
+          vertex_count =
+              std::max({vertex_count, edge._startNode + 1, edge._endNode + 1});
+        }
+        csr._offsets.assign(vertex_count + 1, 0);
+        for (const auto& edge : matrix) {
+          csr._offsets[edge._startNode + 1]++;
+          if (!kIsOriented && edge._startNode != edge._endNode) {
+            csr._offsets[edge._endNode + 1]++;
+          }
+        }
+        for (size_t i = 1; i < csr._offsets.size(); ++i) {
+          csr._offsets[i] += csr._offsets[i - 1];
+        }
 
-      using colour_type = std::tuple<size_t, size_t, std::set<size_t>>;
+        std::vector<std::pair<size_t, ValueType>> entries(csr._offsets.back());
+        std::vector<size_t> position(csr._offsets.begin(),
+                                     csr._offsets.end() - 1);
+        for (const auto& edge : matrix) {
+          entries[position[edge._startNode]++] = {edge._endNode, edge._value};
+          if (!kIsOriented && edge._startNode != edge._endNode) {
+            entries[position[edge._endNode]++] = {edge._startNode,
+                                                  edge._value};
+          }
+        }
 
-      std::vector<colour_type> used_colours(vertexes.size());
+        csr._neighbours.reserve(entries.size());
+        csr._values.reserve(entries.size());
+        for (size_t i = 0; i < vertex_count; ++i) {
+          auto row_begin =
+              entries.begin() + static_cast<int64_t>(csr._offsets[i]);
+          auto row_end =
+              entries.begin() + static_cast<int64_t>(csr._offsets[i + 1]);
+          std::sort(row_begin, row_end, [](const auto& a, const auto& b) {
+            return a.first < b.first;
+          });
+        }
+        for (const auto& [neighbour, value] : entries) {
+          csr._neighbours.push_back(neighbour);
+          csr._values.push_back(value);
+        }
+      }
+      else {
+        static_assert(std::is_same_v<SourceTag, AdjacencyMatrixTag>,
+                      "CsrTag is built from EdgesListTag or AdjacencyMatrixTag");
+        csr._offsets.reserve(matrix.size() + 1);
+        csr._offsets.push_back(0);
+        for (size_t i = 0; i < matrix.size(); ++i) {
+          for (size_t j = 0; j < matrix[i].size(); ++j) {
+            if (matrix[i][j] != 0) {
+              csr._neighbours.push_back(j);
+              csr._values.push_back(matrix[i][j]);
+            }
+          }
+          csr._offsets.push_back(csr._neighbours.size());
+        }
+      }
+      return result;
+    }
+    // dsatur: the next vertex is the uncoloured one with the most distinct
+    // colours around it, ties go to the larger degree from degrees and then
+    // to the smaller index; it takes the smallest colour free around it.
+    // Neighbour colours are one bitmask per vertex and the order is an
+    // indexed max heap updated on every new colour, O((V + E) log V)
+    std::vector<size_t>
+    colorVertexes(const DegreeSequence& degrees)
+    {
+      using word_type = uint64_t;
+      constexpr size_t kWordBits{std::numeric_limits<word_type>::digits};
 
-      size_t colour_idx{};
+      const auto& incidence = getIncidence();
+      size_t vertex_count   = incidence.size();
+      // greedy colouring never needs more than max degree + 1 colours
+      size_t word_count     = (maxIncidentEdges() + 1) / kWordBits + 1;
 
-      auto to_heap = [](colour_type& a, colour_type& b) {
-        size_t a_size = std::get<2>(a).size();
-        size_t b_size = std::get<2>(b).size();
+      std::vector<word_type> masks(vertex_count * word_count, 0);
+      std::vector<size_t> saturation(vertex_count, 0);
+      std::vector<size_t> result_colours(vertex_count, 0);
 
-        return a_size == b_size ? std::get<1>(a) > std::get<1>(b)
-                                : a_size > b_size;
+      auto before = [&saturation, &degrees](size_t a, size_t b) {
+        if (saturation[a] != saturation[b]) {
+          return saturation[a] > saturation[b];
+        }
+        if (degrees[a] != degrees[b]) {
+          return degrees[a] > degrees[b];
+        }
+        return a < b;
       };
 
-      for (auto& colours : used_colours) {
-        std::get<0>(colours) = colour_idx;
-        std::get<1>(colours) = degrees[colour_idx][colour_idx];
-        colour_idx++;
+      std::vector<size_t> heap(vertex_count);
+      std::vector<size_t> position(vertex_count);
+      std::iota(heap.begin(), heap.end(), 0);
+      std::iota(position.begin(), position.end(), 0);
+      auto swap_nodes = [&heap, &position](size_t i, size_t j) {
+        std::swap(heap[i], heap[j]);
+        position[heap[i]] = i;
+        position[heap[j]] = j;
+      };
+      auto sift_up = [&](size_t i) {
+        while (i > 0 && before(heap[i], heap[(i - 1) / 2])) {
+          swap_nodes(i, (i - 1) / 2);
+          i = (i - 1) / 2;
+        }
+      };
+      auto sift_down = [&](size_t i) {
+        for (;;) {
+          size_t best = i;
+          for (size_t child = (2 * i) + 1;
+               child <= (2 * i) + 2 && child < heap.size(); ++child) {
+            if (before(heap[child], heap[best])) {
+              best = child;
+            }
+          }
+          if (best == i) {
+            return;
+          }
+          swap_nodes(i, best);
+          i = best;
+        }
+      };
+      for (size_t i = vertex_count / 2; i-- > 0;) {
+        sift_down(i);
       }
 
-      auto it = used_colours.begin();
+      auto add_colour = [&](size_t vertex, size_t colour_id) {
+        if (position[vertex] >= heap.size()) {
+          return;
+        }
+        word_type& word = masks[(vertex * word_count) + (colour_id / kWordBits)];
+        word_type bit   = word_type{1} << (colour_id % kWordBits);
+        if ((word & bit) == 0) {
+          word |= bit;
+          saturation[vertex]++;
+          sift_up(position[vertex]);
+        }
+      };
 
-      for (size_t i = 0; i < vertexes.size(); ++i) {
-        std::ranges::sort(used_colours, to_heap);
+      while (!heap.empty()) {
+        size_t vertex = heap.front();
+        swap_nodes(0, heap.size() - 1);
+        heap.pop_back();
+        position[vertex] = vertex_count;
+        sift_down(0);
 
-        for (it = used_colours.begin(); it != used_colours.end(); ++it) {
-          size_t idx = std::get<0>(*it);
-          if (coloured[idx]) {
-            continue;
-          }
-          coloured[idx] = true;
-          break;
-        }
         size_t colour_id{};
-
-        for (const auto colour : std::get<std::set<size_t>>(*it)) {
-          if (colour_id != colour) {
+        for (size_t w = 0; w < word_count; ++w) {
+          word_type used = masks[(vertex * word_count) + w];
+          if (used != std::numeric_limits<word_type>::max()) {
+            colour_id = (w * kWordBits) +
+                        static_cast<size_t>(std::countr_one(used));
             break;
           }
-          colour_id++;
         }
+        result_colours[vertex] = colour_id;
 
-        size_t src_idx          = std::get<0>(*it);
-        result_colours[src_idx] = colour_id;
-
-        for (auto& edge : _matrix) {
-          size_t second_node = src_idx;
-          if (edge._startNode == src_idx) {
-            second_node = edge._endNode;
-          }
-          if (edge._endNode == src_idx) {
-            second_node = edge._startNode;
-          }
-          if (second_node == src_idx) {
-            continue;
-          }
-          auto used_colours_it =
-              std::ranges::find_if(used_colours, [second_node](auto& value) {
-                return std::get<0>(value) == second_node;
-              });
-
-          std::get<std::set<size_t>>(*used_colours_it).insert(colour_id);
+        for (size_t edge : incidence.outEdges(vertex)) {
+          add_colour(_matrix[edge]._endNode, colour_id);
+        }
+        for (size_t edge : incidence.inEdges(vertex)) {
+          add_colour(_matrix[edge]._startNode, colour_id);
         }
       }
       return result_colours;
     }
+    // ties broken by getDegreeSequence()
+    std::vector<size_t>
+    colorVertexes()
+    {
+      return colorVertexes(getDegreeSequence());
+    }
+    // first fit in list order: an edge takes the smallest colour used at
+    // neither endpoint, colours in use are kept as one bitmask per vertex.
+    // O(E * max degree / 64)
     std::vector<size_t>
     colorEdges()
     {
-      std::vector<size_t> result_colours(_matrix.size());
-      std::vector<std::set<size_t>> used_colours(_matrix.size());
+      using word_type = uint64_t;
+      constexpr size_t kWordBits{std::numeric_limits<word_type>::digits};
+
+      const auto& incidence = getIncidence();
+      size_t vertex_count   = incidence.size();
+      // first fit never needs more than 2 * max degree - 1 colours
+      size_t word_count = (2 * maxIncidentEdges()) / kWordBits + 1;
+      std::vector<word_type> masks(vertex_count * word_count, 0);
+      auto mask = [&masks, word_count](size_t vertex) {
+        return std::span<word_type>{masks}.subspan(vertex * word_count,
+                                                   word_count);
+      };
 
+      std::vector<size_t> result_colours(_matrix.size());
       for (size_t i = 0; i != result_colours.size(); ++i) {
+        auto start_mask = mask(_matrix[i]._startNode);
+        auto end_mask   = mask(_matrix[i]._endNode);
         size_t colour_id{};
-
-        for (auto colour : used_colours[i]) {
-          if (colour_id != colour) {
+        for (size_t w = 0; w < word_count; ++w) {
+          word_type used = start_mask[w] | end_mask[w];
+          if (used != std::numeric_limits<word_type>::max()) {
+            colour_id = (w * kWordBits) +
+                        static_cast<size_t>(std::countr_one(used));
             break;
           }
-          colour_id++;
         }
-
         result_colours[i] = colour_id;
-
-        for (auto edge = _matrix.begin(); edge != _matrix.end(); ++edge) {
-          if (edge->_startNode == _matrix[i]._startNode ||
-              edge->_startNode == _matrix[i]._endNode ||
-              edge->_endNode == _matrix[i]._endNode ||
-              edge->_endNode == _matrix[i]._startNode) {
-            used_colours[static_cast<size_t>(edge - _matrix.begin())].insert(
-                colour_id);
-          }
-        }
+        word_type bit     = word_type{1} << (colour_id % kWordBits);
+        start_mask[colour_id / kWordBits] |= bit;
+        end_mask[colour_id / kWordBits]   |= bit;
       }
       return result_colours;
     }
 
-    /*
-        void
-        removeEdge(size_t firstNode, size_t secondNode)
-        {
-            _matrix[firstNode][secondNode] = 0;
-          if constexpr (!IsOriented) {
-            _matrix[secondNode][firstNode] = 0;
+    // misra-gries: at most max degree + 1 colours on the simple graph under
+    // the list, the first edge of every unordered (u, v) pair is coloured by
+    // it. An uncoloured edge (u, v) is fixed by building a maximal fan of u
+    // starting at v, flipping the cd path through u and rotating the fan
+    // prefix. Loops and repeated or reversed copies of a pair are coloured
+    // last, first fit over colours above the misra-gries ones, so the result
+    // stays proper on the whole list. O(E * max degree^2)
+    std::vector<size_t>
+    colorEdges(MisraGriesFlag)
+    {
+      constexpr size_t kNone = std::numeric_limits<size_t>::max();
+
+      size_t vertex_count = getIncidence().size();
+
+      // everything misra-gries can not take: loops and repeated pairs
+      std::vector<size_t> extra;
+      std::vector<bool> simple(_matrix.size(), false);
+      std::vector<size_t> simple_degrees(vertex_count, 0);
+      {
+        std::unordered_map<std::pair<size_t, size_t>, size_t, EdgeKeyHash>
+            seen;
+        seen.reserve(_matrix.size());
+        for (size_t edge = 0; edge < _matrix.size(); ++edge) {
+          auto [a, b] = std::minmax(_matrix[edge]._startNode,
+                                    _matrix[edge]._endNode);
+          if (a == b || !seen.try_emplace({a, b}, edge).second) {
+            extra.push_back(edge);
+            continue;
           }
+          simple[edge] = true;
+          ++simple_degrees[a];
+          ++simple_degrees[b];
         }
-    */
-    /*    void
-        clearMatrix()
-        {
-          for (auto& row : _matrix) {
-            for (auto& element : row) {
-              element = 0;
-            }
-          }
+      }
+      size_t colour_count =
+          (simple_degrees.empty() ? 0 : std::ranges::max(simple_degrees)) + 1;
+
+      std::vector<size_t> result_colours(_matrix.size(), kNone);
+      // coloured_edge[v * colour_count + c] is the edge of colour c at v
+      std::vector<size_t> coloured_edge(vertex_count * colour_count, kNone);
+      std::vector<bool> in_fan(vertex_count, false);
+      std::vector<size_t> fan;
+      std::vector<size_t> path;
+
+      auto slot = [&coloured_edge, colour_count](size_t vertex,
+                                                 size_t colour) -> size_t& {
+        return coloured_edge[(vertex * colour_count) + colour];
+      };
+      auto is_free = [&slot](size_t vertex, size_t colour) {
+        return slot(vertex, colour) == kNone;
+      };
+      auto free_colour = [&is_free](size_t vertex) {
+        size_t colour{};
+        while (!is_free(vertex, colour)) {
+          ++colour;
         }
+        return colour;
+      };
+      auto other = [this](size_t edge, size_t vertex) {
+        return _matrix[edge]._startNode == vertex ? _matrix[edge]._endNode
+                                                  : _matrix[edge]._startNode;
+      };
+      auto uncolour = [&](size_t edge) {
+        slot(_matrix[edge]._startNode, result_colours[edge]) = kNone;
+        slot(_matrix[edge]._endNode, result_colours[edge])   = kNone;
+        result_colours[edge]                                 = kNone;
+      };
+      auto colour = [&](size_t edge, size_t colour_id) {
+        result_colours[edge]                      = colour_id;
+        slot(_matrix[edge]._startNode, colour_id) = edge;
+        slot(_matrix[edge]._endNode, colour_id)   = edge;
+      };
 
-        void
-        connectAll(ValueType value = 1)
-        {
-          for (auto& row : _matrix) {
-            for (auto& element : row) {
-              element = value;
+      for (size_t edge = 0; edge < _matrix.size(); ++edge) {
+        if (!simple[edge]) {
+          continue;
+        }
+        size_t u = _matrix[edge]._startNode;
+
+        // fan edges all touch u, the next one has a colour free on the far
+        // end of the previous one
+        fan.assign(1, edge);
+        in_fan[other(edge, u)] = true;
+        for (bool grown = true; grown;) {
+          grown       = false;
+          size_t last = other(fan.back(), u);
+          for (size_t c = 0; c < colour_count && !grown; ++c) {
+            size_t candidate = slot(u, c);
+            if (candidate != kNone && is_free(last, c) &&
+                !in_fan[other(candidate, u)]) {
+              fan.push_back(candidate);
+              in_fan[other(candidate, u)] = true;
+              grown                       = true;
+            }
+          }
+        }
+
+        size_t c = free_colour(u);
+        size_t d = free_colour(other(fan.back(), u));
+
+        // the path from u alternating d and c swaps its colours, which frees
+        // d on u
+        path.clear();
+        for (size_t vertex = u, next_colour = d;
+             slot(vertex, next_colour) != kNone;
+             next_colour = next_colour == d ? c : d) {
+          path.push_back(slot(vertex, next_colour));
+          vertex = other(path.back(), vertex);
+        }
+        std::vector<size_t> path_colours(path.size());
+        for (size_t k = 0; k < path.size(); ++k) {
+          path_colours[k] = result_colours[path[k]] == c ? d : c;
+          uncolour(path[k]);
+        }
+        for (size_t k = 0; k < path.size(); ++k) {
+          colour(path[k], path_colours[k]);
+        }
+
+        // shortest fan prefix ending in a vertex where d is free
+        size_t w{};
+        for (; w < fan.size(); ++w) {
+          if (w > 0 && !is_free(other(fan[w - 1], u), result_colours[fan[w]])) {
+            break;
+          }
+          if (is_free(other(fan[w], u), d)) {
+            break;
+          }
+        }
+        w = std::min(w, fan.size() - 1);
+
+        std::vector<size_t> rotated(w + 1);
+        for (size_t k = 0; k < w; ++k) {
+          rotated[k] = result_colours[fan[k + 1]];
+        }
+        rotated[w] = d;
+        for (size_t k = 1; k <= w; ++k) {
+          uncolour(fan[k]);
+        }
+        for (size_t k = 0; k <= w; ++k) {
+          colour(fan[k], rotated[k]);
+        }
+
+        for (size_t fan_edge : fan) {
+          in_fan[other(fan_edge, u)] = false;
+        }
+      }
+
+      // these meet a misra-gries edge of every colour at worst, so they only
+      // take colours from colour_count on, extra_at[v] are the ones at v
+      std::vector<std::vector<size_t>> extra_at(vertex_count);
+      for (size_t edge : extra) {
+        auto& at_start   = extra_at[_matrix[edge]._startNode];
+        auto& at_end     = extra_at[_matrix[edge]._endNode];
+        size_t colour_id = colour_count;
+        while (std::ranges::find(at_start, colour_id) != at_start.end() ||
+               std::ranges::find(at_end, colour_id) != at_end.end()) {
+          ++colour_id;
+        }
+        result_colours[edge] = colour_id;
+        at_start.push_back(colour_id);
+        if (&at_start != &at_end) {
+          at_end.push_back(colour_id);
+        }
+      }
+      assert(isProperEdgeColouring(result_colours));
+      return result_colours;
+    }
+
+    /*
+        void
+        removeEdge(size_t firstNode, size_t secondNode)
+        {
+            _matrix[firstNode][secondNode] = 0;
+          if constexpr (!IsOriented) {
+            _matrix[secondNode][firstNode] = 0;
+          }
+        }
+    */
+    /*    void
+        clearMatrix()
+        {
+          for (auto& row : _matrix) {
+            for (auto& element : row) {
+              element = 0;
+            }
+          }
+        }
+
+        void
+        connectAll(ValueType value = 1)
+        {
+          for (auto& row : _matrix) {
+            for (auto& element : row) {
+              element = value;
             }
           }
         }
@@ -505,7 +1865,7 @@ namespace graph_first {
     void
     addName<NodeListTag>(const std::string& str, size_t idx)
     {
-      _matrix[idx]._name = str;
+      _matrix.setName(idx, str);
     }
 
     template <size_t NodeAmountSend>
@@ -557,18 +1917,72 @@ namespace graph_first {
     resize(size_t size_new)
     {
       _matrix.resize(size_new);
-      for (auto& row : _matrix) {
-        row.resize(size_new);
-      }
+      _reverse._valid = false;
     }
 
+    // the remove functions throw std::out_of_range on a bad index before
+    // touching the graph
     void
     removeVertex(size_t vertex_index)
     {
-      _matrix.erase(_matrix.begin() + static_cast<int64_t>(vertex_index));
-      for (auto& row : _matrix) {
-        row.erase(row.begin() + static_cast<int64_t>(vertex_index));
+      checkVertex(vertex_index);
+      _matrix.erase(vertex_index);
+      if (vertex_index < _matrix_names.size()) {
+        _matrix_names.erase(_matrix_names.begin() +
+                            static_cast<std::ptrdiff_t>(vertex_index));
+      }
+    }
+
+    // O(V): the last vertex takes the place of the removed one together with
+    // its name, returns its old index. indexes kept outside of the graph for
+    // that vertex are invalid afterwards
+    size_t
+    removeVertexSwap(size_t vertex_index)
+    {
+      checkVertex(vertex_index);
+      size_t moved = _matrix.size() - 1;
+      _matrix.swapErase(vertex_index);
+      if (moved < _matrix_names.size()) {
+        _matrix_names[vertex_index] = std::move(_matrix_names[moved]);
+        _matrix_names.pop_back();
+      }
+      else if (vertex_index < _matrix_names.size()) {
+        _matrix_names[vertex_index].clear();
+      }
+      return moved;
+    }
+
+    // removes all vertexes at once keeping the order of the rest, returns new
+    // index of every old vertex, kUnreachable for the removed ones. names
+    // follow their vertexes, any other stored index has to go through the
+    // returned remap. A repeated index is removed once
+    std::vector<size_t>
+    removeVertices(std::span<const size_t> vertexes)
+    {
+      for (size_t vertex : vertexes) {
+        checkVertex(vertex);
+      }
+      std::vector<size_t> remap(_matrix.size(), 0);
+      for (size_t vertex : vertexes) {
+        remap[vertex] = kUnreachable;
+      }
+      std::vector<size_t> kept;
+      kept.reserve(_matrix.size());
+      for (size_t i = 0; i < remap.size(); ++i) {
+        if (remap[i] != kUnreachable) {
+          remap[i] = kept.size();
+          kept.push_back(i);
+        }
       }
+      _matrix.compact(kept);
+      size_t named = 0;
+      for (size_t i = 0; i < kept.size() && kept[i] < _matrix_names.size();
+           ++i) {
+        _matrix_names[i] = std::move(_matrix_names[kept[i]]);
+        named            = i + 1;
+      }
+      _matrix_names.resize(std::min(named, _matrix_names.size()));
+      return remap;
     }
     /*
     double
@@ -622,8 +2036,9 @@ namespace graph_first {
         allPathes.push_back(path);
       }
       else {
-        for (auto& edge : _matrix) {
-          if (visited[edge._endNode] || edge._startNode != src) {
+        for (size_t edge_idx : getIncidence().outEdges(src)) {
+          const auto& edge = _matrix[edge_idx];
+          if (visited[edge._endNode]) {
             continue;
           }
           visited[edge._endNode] = true;
@@ -635,204 +2050,332 @@ namespace graph_first {
       visited[src] = false;
     }
 
+    // only an edges list can hold repeated edges, other containers have
+    // nothing to drop
     void
     removeExternal()
     {
-      std::vector<size_t> edges_to_remove{};
-      size_t degr{};
-      for (size_t i = 0; i != _matrix.size(); ++i) {
-        for (size_t j = i; j != _matrix.size(); ++j) {
-          if (_matrix[i]._startNode == _matrix[j]._endNode &&
-              _matrix[j]._startNode == _matrix[i]._endNode) {
-            edges_to_remove.push_back(j);
-          }
-        }
-      }
-      for (auto i : edges_to_remove) {
-        _matrix.erase(_matrix.begin() + static_cast<int64_t>(i) -
-                      static_cast<int64_t>(degr++));
+      if constexpr (std::is_same_v<ContainerTag, EdgesListTag>) {
+        deduplicateEdgesImpl(true, EdgeDedupPolicy::KeepFirst);
       }
     }
 
+    // drops repeated edges in one pass, on non-oriented graphs (a, b) and
+    // (b, a) are the same edge. The kept edges stay in list order
+    void
+    deduplicateEdges(EdgeDedupPolicy policy = EdgeDedupPolicy::KeepFirst)
+    {
+      deduplicateEdgesImpl(!kIsOriented, policy);
+    }
+
     std::vector<std::vector<size_t>>
     getAllPathes(size_t point1, size_t point2)
     {
-      std::set<size_t> vertex_count{};
-      std::ranges::for_each(_matrix, [&vertex_count](auto& edge) {
-        vertex_count.insert(edge._startNode);
-        vertex_count.insert(edge._endNode);
-      });
-
       std::vector<std::vector<size_t>> pathes;
-      std::vector<size_t> path;
-      std::vector<bool> visited(vertex_count.size(), false);
-
-      dfs(point1, point2, path, visited, pathes);
+      for (auto path : simplePaths(point1, point2)) {
+        pathes.emplace_back(path.begin(), path.end());
+      }
       removeExternal();
 
       return pathes;
     }
-    size_t
-    processPath(const std::vector<size_t>& path, std::vector<size_t>& edges)
+
+    // lazily yields every simple path from source to target in dfs order.
+    // The span views one buffer that is reused for the next path, copy it to
+    // keep it. Adjacency is snapshotted by this call, later changes of the
+    // graph are not seen by the generator
+    utility::Generator<std::span<const size_t>>
+    simplePaths(size_t source, size_t target)
     {
-      size_t cost = 0;
-      for (size_t i = 0; i != path.size() - 1; ++i) {
-        size_t edge_idx = 0;
-        for (auto& edge : _matrix) {
-          if ((edge._startNode == path[i] && edge._endNode == path[i + 1]) ||
-              (edge._endNode == path[i] && edge._startNode == path[i + 1])) {
-            cost += edge._value;
-            edges.push_back(edge_idx);
-            break;
-          }
-          edge_idx++;
-        }
+      prepareAdjacency();
+      return simplePaths(getCsr(), source, target);
+    }
+
+    // same paths as simplePaths spread over hardwareThreads() workers.
+    // sink(thread_idx, path) runs concurrently for different thread_idx, the
+    // path span is only valid during the call, order is unspecified
+    template <typename Sink>
+    void
+    simplePaths(size_t source, size_t target, ParallelFlag, Sink&& sink)
+    {
+      prepareAdjacency();
+      auto csr = getCsr();
+      parallelPaths(csr, source, target, sink);
+    }
+
+    std::vector<std::vector<size_t>>
+    getAllPathes(size_t point1, size_t point2, ParallelFlag)
+    {
+      std::vector<std::vector<std::vector<size_t>>> sinks(hardwareThreads());
+      simplePaths(point1, point2, ParallelFlag{},
+                  [&sinks](size_t thread_idx, std::span<const size_t> path) {
+                    sinks[thread_idx].emplace_back(path.begin(), path.end());
+                  });
+
+      std::vector<std::vector<size_t>> pathes;
+      for (auto& sink : sinks) {
+        std::ranges::move(sink, std::back_inserter(pathes));
       }
-      return cost;
+      removeExternal();
+
+      return pathes;
     }
-    template <>
-    bool
-    isThereChain<NodeListTag>(std::span<size_t> vertexes)
+    // yen: the next path leaves one of the accepted ones at a spur vertex,
+    // the spur search runs with the shared root prefix blocked and with the
+    // edges the accepted paths take out of the spur removed. Returns up to k
+    // simple paths as (cost, vertexes), cheapest first
+    std::vector<std::pair<uint64_t, std::vector<size_t>>>
+    kShortestPaths(size_t source, size_t target, size_t k) const
     {
-      for (size_t i = 0; i < vertexes.size() - 1; ++i) {
-        bool check{false};
-        for (auto& neight : _matrix[vertexes[i]]._neighbours) {
-          if (neight == vertexes[i + 1]) {
-            check = true;
-            break;
+      prepareAdjacency();
+      using path_type = std::pair<uint64_t, std::vector<size_t>>;
+
+      std::vector<path_type> result;
+      size_t vertex_count = vertexCount();
+      if (k == 0 || source >= vertex_count || target >= vertex_count) {
+        return result;
+      }
+
+      std::vector<bool> blocked(vertex_count, false);
+      std::vector<size_t> blocked_next;
+      std::set<path_type> candidates;
+
+      auto first = shortestPathAvoiding(source, target, blocked, blocked_next);
+      if (first.second.empty()) {
+        return result;
+      }
+      result.push_back(std::move(first));
+
+      while (result.size() < k) {
+        std::vector<size_t> previous = result.back().second;
+        uint64_t root_cost{};
+        for (size_t i = 0; i + 1 < previous.size(); ++i) {
+          size_t spur = previous[i];
+          auto root   = std::span<const size_t>{previous}.first(i + 1);
+
+          blocked_next.clear();
+          for (const auto& [cost, path] : result) {
+            if (path.size() > i + 1 &&
+                std::equal(root.begin(), root.end(), path.begin())) {
+              blocked_next.push_back(path[i + 1]);
+            }
           }
+          for (size_t j = 0; j < i; ++j) {
+            blocked[previous[j]] = true;
+          }
+          auto [spur_cost, spur_path] =
+              shortestPathAvoiding(spur, target, blocked, blocked_next);
+          for (size_t j = 0; j < i; ++j) {
+            blocked[previous[j]] = false;
+          }
+
+          if (!spur_path.empty()) {
+            std::vector<size_t> total(root.begin(), root.end() - 1);
+            total.insert(total.end(), spur_path.begin(), spur_path.end());
+            candidates.emplace(root_cost + spur_cost, std::move(total));
+          }
+          root_cost += minEdgeValue(spur, previous[i + 1]);
         }
-        if (!check) {
-          return false;
-        }
-      }
 
-      for (auto& neghb : _matrix[vertexes[vertexes.size() - 1]]._neighbours) {
-        if (neghb == vertexes[0]) {
-          return true;
+        if (candidates.empty()) {
+          break;
         }
+        result.push_back(candidates.extract(candidates.begin()).value());
       }
-      return false;
+      return result;
     }
 
-    template <>
-    bool
-    isThereChain<EdgesListTag>(std::span<size_t> vertexes)
+    // cheapest path from source to target whose edges all have different
+    // colours, colours[edge] as given by colorEdges. Labels (vertex, used
+    // colours, cost) are settled in cost order and a label is dropped when
+    // another one at the same vertex used a subset of its colours for no
+    // more cost. Returns (cost, edge ids); source == target is cost 0 with
+    // no edges. colours needs one entry per edge and colours above 63 are
+    // not supported, both are reported as errors apart from NoPath
+    std::expected<std::pair<uint64_t, std::vector<size_t>>, RainbowPathError>
+    rainbowShortestPath(size_t source, size_t target,
+                        std::span<const size_t> colours) const
     {
-      for (size_t i = 0; i < vertexes.size() - 1; ++i) {
-        bool check = false;
+      using mask_type = uint64_t;
+      constexpr size_t kMaskBits{std::numeric_limits<mask_type>::digits};
+      constexpr size_t kNone = std::numeric_limits<size_t>::max();
+
+      struct Label {
+        size_t _vertex;
+        mask_type _colours;
+        uint64_t _cost;
+        size_t _parent;
+        size_t _edge;
+        bool _dominated;
+      };
+      using queue_entry = std::pair<uint64_t, size_t>;
 
-        for (auto& edge : _matrix) {
-          if (edge._startNode == vertexes[i] &&
-              edge._endNode == vertexes[i + 1]) {
-            check = true;
-            break;
-          }
+      std::pair<uint64_t, std::vector<size_t>> result{0, {}};
+      const auto& incidence = getIncidence();
+      if (source >= incidence.size() || target >= incidence.size()) {
+        return std::unexpected(RainbowPathError::VertexOutOfRange);
+      }
+      if (colours.size() < _matrix.size()) {
+        return std::unexpected(RainbowPathError::ColoursTooShort);
+      }
+      if (std::ranges::any_of(colours.first(_matrix.size()),
+                              [](size_t colour) {
+                                return colour >= kMaskBits;
+                              })) {
+        return std::unexpected(RainbowPathError::TooManyColours);
+      }
+
+      std::vector<Label> labels{{source, 0, 0, kNone, kNone, false}};
+      // labels of every vertex nobody dominates yet
+      std::vector<std::vector<size_t>> front(incidence.size());
+      front[source].push_back(0);
+      std::priority_queue<queue_entry, std::vector<queue_entry>, std::greater<>>
+          queue;
+      queue.emplace(0, 0);
+
+      auto relax = [&](size_t parent, size_t edge, size_t next) {
+        mask_type bit = mask_type{1} << colours[edge];
+        if ((labels[parent]._colours & bit) != 0) {
+          return;
         }
-        if (!check) {
-          return false;
+        mask_type used = labels[parent]._colours | bit;
+        uint64_t cost  = labels[parent]._cost +
+                        static_cast<uint64_t>(_matrix[edge]._value);
+
+        auto& candidates = front[next];
+        for (size_t other : candidates) {
+          if ((labels[other]._colours & ~used) == 0 &&
+              labels[other]._cost <= cost) {
+            return;
+          }
         }
-      }
+        std::erase_if(candidates, [&labels, used, cost](size_t other) {
+          bool dominated = (used & ~labels[other]._colours) == 0 &&
+                           cost <= labels[other]._cost;
+          labels[other]._dominated |= dominated;
+          return dominated;
+        });
+        candidates.push_back(labels.size());
+        queue.emplace(cost, labels.size());
+        labels.push_back({next, used, cost, parent, edge, false});
+      };
 
-      for (auto& edge : _matrix) {
-        if (edge._startNode == vertexes[vertexes.size() - 1] &&
-            edge._endNode == vertexes[0]) {
-          return true;
+      while (!queue.empty()) {
+        auto [cost, label] = queue.top();
+        queue.pop();
+        if (labels[label]._dominated) {
+          continue;
+        }
+        size_t vertex = labels[label]._vertex;
+        if (vertex == target) {
+          result.first = cost;
+          for (size_t k = label; labels[k]._parent != kNone;
+               k = labels[k]._parent) {
+            result.second.push_back(labels[k]._edge);
+          }
+          std::ranges::reverse(result.second);
+          return result;
+        }
+        for (size_t edge : incidence.outEdges(vertex)) {
+          relax(label, edge, _matrix[edge]._endNode);
+        }
+        if constexpr (!kIsOriented) {
+          for (size_t edge : incidence.inEdges(vertex)) {
+            relax(label, edge, _matrix[edge]._startNode);
+          }
         }
       }
-      return false;
+      return std::unexpected(RainbowPathError::NoPath);
     }
 
-    template <typename Tag = ContainerTag>
-    std::vector<std::pair<size_t, ValueType>>
-    getBigVertexes(ValueType limit)
+    size_t
+    processPath(const std::vector<size_t>& path, std::vector<size_t>& edges)
     {
-      std::unordered_map<size_t, ValueType> vertexes{};
-      std::set<size_t> done_pairs;
-
-      std::vector<std::pair<size_t, ValueType>> res;
-
-      for (size_t i = 0; i < _matrix.size(); ++i) {
-        for (size_t j = 0; j < _matrix[i].size(); ++j) {
-          if (done_pairs.contains(i)) {
+      const auto& incidence = getIncidence();
+      size_t cost           = 0;
+      for (size_t i = 0; i != path.size() - 1; ++i) {
+        // first edge of the list joining the pair in either direction
+        size_t edge_idx{_matrix.size()};
+        for (size_t edge : incidence.outEdges(path[i])) {
+          if (_matrix[edge]._endNode == path[i + 1]) {
+            edge_idx = edge;
             break;
           }
-          if (done_pairs.contains(j)) {
-            continue;
+        }
+        for (size_t edge : incidence.inEdges(path[i])) {
+          if (edge >= edge_idx) {
+            break;
           }
-
-          size_t val{};
-
-          bool res_l   = _matrix[i][j] != 0;
-          val         += res_l ? _matrix[i][j] : 0;
-          res_l        = _matrix[j][i] != 0;
-          val         += res_l ? _matrix[j][i] : 0;
-
-          vertexes[i] += val;
-          vertexes[j] += val;
-
-          vertexes[i] > limit                        ? done_pairs.insert(i),
-              void(res.emplace_back(i, vertexes[i])) : void();
-          vertexes[j] > limit                        ? done_pairs.insert(j),
-              void(res.emplace_back(j, vertexes[j])) : void();
+          if (_matrix[edge]._startNode == path[i + 1]) {
+            edge_idx = edge;
+            break;
+          }
+        }
+        if (edge_idx != _matrix.size()) {
+          cost += _matrix[edge_idx]._value;
+          edges.push_back(edge_idx);
         }
       }
-      return res;
+      return cost;
     }
-
     template <>
-    std::vector<std::pair<size_t, ValueType>>
-    getBigVertexes<EdgesListTag>(ValueType limit)
+    bool
+    isThereChain<NodeListTag>(std::span<size_t> vertexes)
     {
-      std::unordered_map<size_t, ValueType> vertexes{};
-      std::set<size_t> done_pairs;
-
-      std::vector<std::pair<size_t, ValueType>> res;
-
-      for (size_t i = 0; i < _matrix.size(); ++i) {
-        size_t st  = _matrix[i]._startNode;
-        size_t end = _matrix[i]._endNode;
-        size_t val = _matrix[i]._value;
-
-        if (!done_pairs.contains(st)) {
-          vertexes[st] += val;
-          vertexes[st] > limit                         ? done_pairs.insert(st),
-              void(res.emplace_back(st, vertexes[st])) : void();
-        }
-        if (!done_pairs.contains(end)) {
-          vertexes[end] += val;
-          vertexes[end] > limit ? done_pairs.insert(end),
-              void(res.emplace_back(end, vertexes[end])) : void();
+      _matrix.normalize();
+      auto adjacent = [this](size_t from, size_t to) {
+        return std::ranges::binary_search(_matrix.neighbours(from), to);
+      };
+      for (size_t i = 0; i < vertexes.size() - 1; ++i) {
+        if (!adjacent(vertexes[i], vertexes[i + 1])) {
+          return false;
         }
       }
-      return res;
+      return adjacent(vertexes[vertexes.size() - 1], vertexes[0]);
     }
 
     template <>
-    std::vector<std::pair<size_t, ValueType>>
-    getBigVertexes<NodeListTag>(ValueType limit)
+    bool
+    isThereChain<EdgesListTag>(std::span<size_t> vertexes)
     {
-      std::unordered_map<size_t, ValueType> vertexes{};
-      std::set<size_t> done_pairs;
-
-      std::vector<std::pair<size_t, ValueType>> res;
+      const auto& incidence = getIncidence();
+      auto adjacent         = [this, &incidence](size_t from, size_t to) {
+        return std::ranges::any_of(incidence.outEdges(from),
+                                   [this, to](size_t edge) {
+                                     return _matrix[edge]._endNode == to;
+                                   });
+      };
+      for (size_t i = 0; i < vertexes.size() - 1; ++i) {
+        if (!adjacent(vertexes[i], vertexes[i + 1])) {
+          return false;
+        }
+      }
+      return adjacent(vertexes[vertexes.size() - 1], vertexes[0]);
+    }
 
-      for (size_t i = 0; i < _matrix.size(); ++i) {
-        for (size_t j = 0; j < _matrix[i]._edges.size(); ++j) {
-          size_t st  = _matrix[i]._idx;
-          size_t end = _matrix[i]._edges[j].first;
-          size_t val = _matrix[i]._edges[j].second;
+    // number of edge ends at every vertex, a loop counts twice
+    [[nodiscard]] std::vector<uint64_t>
+    degreeVector() const
+    {
+      return incidentSums<false>();
+    }
+    // sum of the values of the edges at every vertex, a loop counts twice
+    [[nodiscard]] std::vector<uint64_t>
+    strengthVector() const
+    {
+      return incidentSums<true>();
+    }
 
-          if (!done_pairs.contains(st)) {
-            vertexes[st] += val;
-            vertexes[st] > limit ? done_pairs.insert(st),
-                void(res.emplace_back(st, vertexes[st])) : void();
-          }
-          if (!done_pairs.contains(end)) {
-            vertexes[end] += val;
-            vertexes[end] > limit ? done_pairs.insert(end),
-                void(res.emplace_back(end, vertexes[end])) : void();
-          }
+    // vertexes with strength above limit, in index order. strength is kept
+    // as uint64_t, a sum of several edges does not fit into ValueType
+    std::vector<std::pair<size_t, uint64_t>>
+    getBigVertexes(ValueType limit) const
+    {
+      auto strength = strengthVector();
+      std::vector<std::pair<size_t, uint64_t>> res;
+      for (size_t i = 0; i < strength.size(); ++i) {
+        if (std::cmp_greater(strength[i], limit)) {
+          res.emplace_back(i, strength[i]);
         }
       }
       return res;
@@ -852,14 +2395,20 @@ namespace graph_first {
     void
     addEntry(size_t idx, const std::string name)
     {
-      _matrix.push_back({idx, name});
+      if constexpr (std::is_same_v<ContainerTag, NodeListTag>) {
+        _matrix.addNode(idx, name);
+      }
+      else {
+        _matrix.push_back({idx, name});
+      }
     }
     std::vector<std::string_view>
     getNames(NodeListTag)
     {
       std::vector<std::string_view> res;
-      for (auto& i : _matrix) {
-        res.push_back(i._name);
+      res.reserve(_matrix.size());
+      for (size_t i = 0; i < _matrix.size(); ++i) {
+        res.push_back(_matrix.name(i));
       }
       return res;
     }
@@ -914,9 +2463,10 @@ namespace graph_first {
     bfsEdges<NodeListTag>(size_t)
     {
       std::set<std::pair<size_t, size_t>> res;
-      for (auto& i : _matrix) {
-        for (size_t j = 0; j < i._edges.size(); ++j) {
-          res.emplace(i._idx, i._edges[j].first);
+      _matrix.normalize();
+      for (size_t i = 0; i < _matrix.size(); ++i) {
+        for (const auto& edge : _matrix.edges(i)) {
+          res.emplace(_matrix.id(i), edge._node);
         }
       }
       return res;
@@ -925,8 +2475,12 @@ namespace graph_first {
     std::vector<size_t>
     bfs(size_t start = 0)
     {
-      std::vector<bool> visited(_matrix.size(), false);
-      std::vector<size_t> res(_matrix.size());
+      prepareAdjacency();
+      if constexpr (kIsBitMatrix) {
+        return bfsBits(start);
+      }
+      std::vector<bool> visited(vertexCount(), false);
+      std::vector<size_t> res(vertexCount());
       std::queue<size_t> q;
 
       res[start] = 0;
@@ -938,99 +2492,538 @@ namespace graph_first {
         q.pop();
         visited[current] = true;
 
-        for (size_t i = 0; i < _matrix[current].size(); ++i) {
-          if (!visited[i] && _matrix[current][i] != 0) {
+        forEachNeighbour(current, [&](size_t i, ValueType) {
+          if (!visited[i]) {
             visited[i] = true;
             res[i]     = res[current] + 1;
             q.push(i);
           }
-        }
+        });
       }
 
       return res;
     }
 
-    double
-    averagePath()
+    // direction-optimizing bfs (Beamer): frontier expands top-down from a
+    // queue while it is small and switches to bottom-up over a bitmap when
+    // the frontier edges outweigh the unexplored ones. Same levels as bfs().
+    // Workers are started once per traversal and meet at a barrier after
+    // every level, its completion step merges the level and picks the next
+    // direction on one thread. Frontiers of one chunk are expanded right there
+    // while the workers sleep, so long thin graphs run serially
+    std::vector<size_t>
+    bfs(size_t start, ParallelFlag) const
     {
-      uint64_t sum_path{};
-      for (size_t i = 0; i < _matrix.size(); ++i) {
-        for (size_t j = i + 1; j < _matrix.size(); ++j) {
-          uint64_t temp  = _matrix[i][j] != 0
-                               ? static_cast<uint64_t>(_matrix[i][j])
-                               : static_cast<uint64_t>(djkstra(i, j));
-          sum_path      += temp != kNodeValueMax ? temp : 0;
-        }
+      prepareAdjacency();
+      using word_type = uint64_t;
+      constexpr size_t kWordBits{std::numeric_limits<word_type>::digits};
+      constexpr size_t kAlpha{15};
+      constexpr size_t kBeta{18};
+      constexpr size_t kChunkSize{kWordBits * 16};
+
+      auto out_edges = getCsr();
+      CsrStorage<ValueType> transposed{};
+      if constexpr (kIsOriented) {
+        transposed = transposeCsr(out_edges);
       }
-      return static_cast<double>(sum_path) /
-             static_cast<double>(_matrix.size() * (_matrix.size() - 1));
-    }
+      const auto& in_edges = kIsOriented ? transposed : out_edges;
+
+      size_t vertex_count = out_edges.size();
+      size_t word_count   = (vertex_count + kWordBits - 1) / kWordBits;
+      // small graphs are not worth a thread
+      size_t thread_count =
+          std::clamp<size_t>(vertex_count / kChunkSize, 1, hardwareThreads());
+      auto degree = [&out_edges](size_t vertex) {
+        return out_edges._offsets[vertex + 1] - out_edges._offsets[vertex];
+      };
+      auto bit = [](size_t vertex) {
+        return word_type{1} << (vertex % kWordBits);
+      };
 
-    std::vector<std::vector<size_t>>
-    getClusters(ClustersFlag)
-    {
-      std::vector<std::vector<size_t>> result;
-      std::vector<size_t> vec(_matrix.size());
-      auto it      = vec.begin();
-      auto it_prev = vec.begin();
-
-      while (it != vec.end()) {
-        size_t index                 = static_cast<size_t>(it - vec.begin());
-        std::vector<size_t> vec_temp = bfs(index);
-        vec_temp[index]              = 1;
-
-        std::ranges::transform(vec, vec_temp, vec.begin(),
-                               [](size_t a1, size_t a2) { return a1 | a2; });
-
-        it = std::ranges::find(vec, 0);
-        if (it != it_prev) {
-          size_t i = 0;
-          std::vector<size_t> temp;
-          std::ranges::for_each(vec_temp, [&i, &temp](auto edge_count) {
-            if (edge_count != 0) {
-              temp.push_back(i);
+      std::vector<size_t> res(vertex_count);
+      std::vector<std::atomic<word_type>> visited(word_count);
+      std::vector<word_type> frontier_bits(word_count);
+      std::vector<word_type> next_bits(word_count);
+      std::vector<std::vector<size_t>> next_frontiers(thread_count);
+      std::vector<size_t> awake_edges(thread_count);
+      std::vector<size_t> awake_counts(thread_count);
+
+      std::vector<size_t> frontier{start};
+      visited[start / kWordBits].fetch_or(bit(start));
+      size_t unexplored_edges = out_edges._neighbours.size() - degree(start);
+      size_t awake_count      = 1;
+      size_t level            = 1;
+      bool bottom_up          = false;
+      bool done               = false;
+      std::atomic<size_t> next_chunk{};
+
+      auto prepare_level = [&]() {
+        std::ranges::fill(awake_edges, 0);
+        std::ranges::fill(awake_counts, 0);
+        next_chunk.store(0, std::memory_order_relaxed);
+        if (bottom_up) {
+          return;
+        }
+        size_t frontier_edges{};
+        for (size_t vertex : frontier) {
+          frontier_edges += degree(vertex);
+        }
+        if (frontier_edges > unexplored_edges / kAlpha) {
+          bottom_up = true;
+          std::ranges::fill(frontier_bits, 0);
+          for (size_t vertex : frontier) {
+            frontier_bits[vertex / kWordBits] |= bit(vertex);
+          }
+        }
+      };
+      auto merge_level = [&]() {
+        if (bottom_up) {
+          frontier_bits.swap(next_bits);
+
+          size_t previous_count = awake_count;
+          awake_count = std::accumulate(awake_counts.begin(), awake_counts.end(),
+                                        size_t{});
+          if (awake_count < vertex_count / kBeta && awake_count < previous_count) {
+            bottom_up = false;
+            frontier.clear();
+            for (size_t w = 0; w < word_count; ++w) {
+              for (word_type bits = frontier_bits[w]; bits != 0;
+                   bits &= bits - 1) {
+                frontier.push_back((w * kWordBits) +
+                                   static_cast<size_t>(std::countr_zero(bits)));
+              }
             }
-            ++i;
-          });
-          result.emplace_back(std::move(temp));
-          it_prev = it;
+          }
         }
-      }
-      return result;
-    }
-    size_t
-    getClusters()
-    {
-      return getClusters({}).size();
-    }
-
-    size_t
-    getBiggestCluster()
-    {
-      size_t kluster_size_final{std::numeric_limits<size_t>::min()};
-
-      std::vector<size_t> vec(_matrix.size());
-      auto it = vec.begin();
+        else {
+          frontier.clear();
+          for (auto& next : next_frontiers) {
+            frontier.insert(frontier.end(), next.begin(), next.end());
+            next.clear();
+          }
+          awake_count = frontier.size();
+        }
+        unexplored_edges -= std::accumulate(awake_edges.begin(),
+                                            awake_edges.end(), size_t{});
+        done = awake_count == 0;
+        if (!done) {
+          ++level;
+          prepare_level();
+        }
+      };
 
-      while (it != vec.end()) {
-        size_t index                 = static_cast<size_t>(it - vec.begin());
+      // bottom-up chunks cover whole words, so every word of next_bits has one
+      // writer
+      auto bottom_up_chunk = [&](size_t thread_idx, size_t begin, size_t end) {
+        for (size_t w = begin / kWordBits;
+             w < (end + kWordBits - 1) / kWordBits; ++w) {
+          next_bits[w] = 0;
+        }
+        for (size_t i = begin; i < end; ++i) {
+          if ((visited[i / kWordBits].load(std::memory_order_relaxed) &
+               bit(i)) != 0) {
+            continue;
+          }
+          for (size_t parent : in_edges.neighbours(i)) {
+            if ((frontier_bits[parent / kWordBits] & bit(parent)) == 0) {
+              continue;
+            }
+            res[i] = level;
+            visited[i / kWordBits].fetch_or(bit(i), std::memory_order_relaxed);
+            next_bits[i / kWordBits] |= bit(i);
+            awake_counts[thread_idx]++;
+            awake_edges[thread_idx] += degree(i);
+            break;
+          }
+        }
+      };
+      auto top_down_chunk = [&](size_t thread_idx, size_t begin, size_t end) {
+        auto& next = next_frontiers[thread_idx];
+        for (size_t k = begin; k < end; ++k) {
+          for (size_t i : out_edges.neighbours(frontier[k])) {
+            if ((visited[i / kWordBits].load(std::memory_order_relaxed) &
+                 bit(i)) != 0) {
+              continue;
+            }
+            word_type before = visited[i / kWordBits].fetch_or(
+                bit(i), std::memory_order_relaxed);
+            if ((before & bit(i)) == 0) {
+              res[i] = level;
+              next.push_back(i);
+              awake_edges[thread_idx] += degree(i);
+            }
+          }
+        }
+      };
 
-        std::vector<size_t> vec_temp = bfs(index);
-        vec_temp[index]              = 1;
+      auto finish_level = [&]() noexcept {
+        merge_level();
+        while (!done && !bottom_up && frontier.size() <= kWordBits) {
+          top_down_chunk(0, 0, frontier.size());
+          merge_level();
+        }
+      };
 
-        std::ranges::transform(vec, vec_temp, vec.begin(),
-                               [](size_t a1, size_t a2) { return a1 || a2; });
+      std::barrier sync(static_cast<std::ptrdiff_t>(thread_count),
+                        finish_level);
+      auto worker = [&](size_t thread_idx) {
+        while (!done) {
+          size_t count = bottom_up ? vertex_count : frontier.size();
+          size_t chunk = bottom_up ? kChunkSize : kWordBits;
+          for (size_t begin = next_chunk.fetch_add(chunk); begin < count;
+               begin        = next_chunk.fetch_add(chunk)) {
+            size_t end = std::min(begin + chunk, count);
+            if (bottom_up) {
+              bottom_up_chunk(thread_idx, begin, end);
+            }
+            else {
+              top_down_chunk(thread_idx, begin, end);
+            }
+          }
+          sync.arrive_and_wait();
+        }
+      };
+
+      prepare_level();
+      while (!done && !bottom_up && frontier.size() <= kWordBits) {
+        top_down_chunk(0, 0, frontier.size());
+        merge_level();
+      }
+      if (done) {
+        return res;
+      }
+      std::vector<std::jthread> threads;
+      threads.reserve(thread_count - 1);
+      for (size_t t = 1; t < thread_count; ++t) {
+        threads.emplace_back(worker, t);
+      }
+      worker(0);
+
+      return res;
+    }
+
+    // bit-parallel bfs from many sources at once (MS-BFS, Then et al.): every
+    // batch of 64 sources shares one scan of the adjacency,
+    // visitor(source_idx, vertex, depth) is called once per reached pair
+    template <typename Visitor>
+    void
+    multiSourceBfs(std::span<const size_t> sources, Visitor&& visitor) const
+    {
+      auto adjacency = getCsr();
+      for (size_t begin = 0; begin < sources.size(); begin += kBfsBatch) {
+        multiSourceBfsBatch(
+            adjacency,
+            sources.subspan(begin, std::min(kBfsBatch, sources.size() - begin)),
+            [&](size_t source, size_t vertex, uint64_t depth) {
+              visitor(begin + source, vertex, depth);
+            });
+      }
+    }
+
+    // greatest bfs distance to a reachable vertex, for every vertex
+    [[nodiscard]] std::vector<uint64_t>
+    getEccentricities() const
+    {
+      prepareAdjacency();
+      size_t vertex_count = vertexCount();
+      auto adjacency      = getCsr();
+      std::vector<uint64_t> result(vertex_count);
+
+      parallelFor(vertex_count, kBfsBatch,
+                  [&](size_t, size_t begin, size_t end) {
+                    std::array<size_t, kBfsBatch> sources{};
+                    std::iota(sources.begin(), sources.end(), begin);
+                    multiSourceBfsBatch(
+                        adjacency,
+                        std::span<const size_t>{sources}.first(end - begin),
+                        [&](size_t source, size_t, uint64_t depth) {
+                          result[begin + source] =
+                              std::max(result[begin + source], depth);
+                        });
+                  });
+      return result;
+    }
+
+    // exact diameter, radius and center with eccentricity bounds
+    // (Takes-Kosters): every bfs from v tightens
+    // max(d(v, w), e(v) - d(v, w)) <= e(w) <= e(v) + d(v, w) and vertexes that
+    // can't change the answer any more are dropped, so only a few bfs runs are
+    // needed. Oriented graphs fall back to all eccentricities
+    [[nodiscard]] ExtremalDistances
+    getExtremalDistances() const
+    {
+      prepareAdjacency();
+      size_t vertex_count = vertexCount();
+      ExtremalDistances result{};
+      if (vertex_count == 0) {
+        return result;
+      }
+
+      std::vector<uint64_t> lower(vertex_count, 0);
+      std::vector<uint64_t> upper(vertex_count, kUnreachable);
+
+      if constexpr (kIsOriented) {
+        lower = upper = getEccentricities();
+      }
+      else {
+        std::vector<size_t> degrees(vertex_count);
+        for (size_t i = 0; i < vertex_count; ++i) {
+          forEachNeighbour(i, [&degrees, i](size_t, ValueType) { degrees[i]++; });
+        }
+
+        std::vector<size_t> candidates(vertex_count);
+        std::iota(candidates.begin(), candidates.end(), 0);
+        std::vector<uint64_t> distances;
+        std::vector<size_t> queue;
+        uint64_t diameter_lower{};
+        uint64_t radius_upper{kUnreachable};
+        bool pick_upper{true};
+
+        while (!candidates.empty()) {
+          auto picked = pick_upper
+                            ? std::ranges::max_element(
+                                  candidates,
+                                  [&](size_t a, size_t b) {
+                                    return std::pair{upper[a], degrees[a]} <
+                                           std::pair{upper[b], degrees[b]};
+                                  })
+                            : std::ranges::min_element(
+                                  candidates, [&](size_t a, size_t b) {
+                                    return std::pair{lower[a], degrees[b]} <
+                                           std::pair{lower[b], degrees[a]};
+                                  });
+          size_t source = *picked;
+          pick_upper    = !pick_upper;
+
+          hopDistances(source, distances, queue);
+          uint64_t eccentricity = distances[queue.back()];
+          lower[source] = upper[source] = eccentricity;
+          diameter_lower = std::max(diameter_lower, eccentricity);
+          radius_upper   = std::min(radius_upper, eccentricity);
+
+          for (size_t vertex : queue) {
+            uint64_t distance = distances[vertex];
+            lower[vertex]     = std::max(
+                {lower[vertex], distance, eccentricity - distance});
+            upper[vertex] = std::min(upper[vertex], eccentricity + distance);
+          }
+
+          std::erase_if(candidates, [&](size_t vertex) {
+            bool exact = lower[vertex] == upper[vertex];
+            if (exact) {
+              diameter_lower = std::max(diameter_lower, lower[vertex]);
+              radius_upper   = std::min(radius_upper, lower[vertex]);
+            }
+            return upper[vertex] <= diameter_lower &&
+                   (exact || lower[vertex] > radius_upper);
+          });
+        }
+      }
+
+      result._diameter = *std::ranges::max_element(upper);
+      result._radius   = *std::ranges::min_element(upper);
+      for (size_t i = 0; i < vertex_count; ++i) {
+        if (lower[i] == result._radius) {
+          result._center.push_back(i);
+        }
+      }
+      return result;
+    }
+
+    double
+    averagePath()
+    {
+      return getPathStatistics()._averagePath;
+    }
+
+    // one traversal per source spread over all hardware threads: batches of
+    // multi-source bfs for unweighted graphs, dijkstra otherwise. Average
+    // path, diameter, radius and center all come from the same sweep, in
+    // that traversal's metric
+    [[nodiscard]] PathStatistics
+    getPathStatistics() const
+    {
+      prepareAdjacency();
+      size_t vertex_count = vertexCount();
+      size_t thread_count = hardwareThreads();
+
+      std::vector<uint64_t> sums(thread_count);
+      // every source is written by the one thread that owns it
+      std::vector<uint64_t> eccentricities(vertex_count);
+
+      if constexpr (kIsWeighted) {
+        parallelFor(vertex_count, 1, [&](size_t thread_idx, size_t i, size_t) {
+          auto row = getDistances(i);
+          for (size_t j = 0; j < vertex_count; ++j) {
+            if (row[j] == kUnreachable) {
+              continue;
+            }
+            sums[thread_idx]  += j > i ? row[j] : 0;
+            eccentricities[i]  = std::max(eccentricities[i], row[j]);
+          }
+        });
+      }
+      else {
+        auto adjacency = getCsr();
+        parallelFor(vertex_count, kBfsBatch,
+                    [&](size_t thread_idx, size_t begin, size_t end) {
+                      uint64_t sum{};
+                      std::array<size_t, kBfsBatch> sources{};
+                      std::iota(sources.begin(), sources.end(), begin);
+                      multiSourceBfsBatch(
+                          adjacency,
+                          std::span<const size_t>{sources}.first(end - begin),
+                          [&](size_t source, size_t vertex, uint64_t depth) {
+                            sum += vertex > begin + source ? depth : 0;
+                            eccentricities[begin + source] = std::max(
+                                eccentricities[begin + source], depth);
+                          });
+                      sums[thread_idx] += sum;
+                    });
+      }
+
+      PathStatistics result{};
+      if (vertex_count == 0) {
+        return result;
+      }
+      uint64_t sum_path = std::accumulate(sums.begin(), sums.end(), uint64_t{});
+      result._diameter  = *std::ranges::max_element(eccentricities);
+      result._radius    = *std::ranges::min_element(eccentricities);
+      for (size_t i = 0; i < vertex_count; ++i) {
+        if (eccentricities[i] == result._radius) {
+          result._center.push_back(i);
+        }
+      }
+      result._averagePath =
+          static_cast<double>(sum_path) /
+          static_cast<double>(vertex_count * (vertex_count - 1));
+      return result;
+    }
+
+    std::vector<std::vector<size_t>>
+    getClusters(ClustersFlag)
+    {
+      auto components = getComponents();
+      std::vector<std::vector<size_t>> result(components._sizes.size());
+      for (size_t i = 0; i < result.size(); ++i) {
+        result[i].reserve(components._sizes[i]);
+      }
+      for (size_t i = 0; i < components._labels.size(); ++i) {
+        result[components._labels[i]].push_back(i);
+      }
+      return result;
+    }
+    size_t
+    getClusters()
+    {
+      return getComponents()._sizes.size();
+    }
+
+    size_t
+    getBiggestCluster()
+    {
+      auto components = getComponents();
+      return components._sizes.empty()
+                 ? 0
+                 : components._sizes[components._giant];
+    }
+
+    // union-find over every edge, edge direction is ignored
+    [[nodiscard]] ComponentLabels
+    getComponents() const
+    {
+      prepareAdjacency();
+      std::vector<size_t> parents(vertexCount());
+      std::vector<size_t> sizes(vertexCount(), 1);
+      std::iota(parents.begin(), parents.end(), 0);
+
+      auto find = [&parents](size_t vertex) {
+        while (parents[vertex] != vertex) {
+          parents[vertex] = parents[parents[vertex]];
+          vertex          = parents[vertex];
+        }
+        return vertex;
+      };
+
+      for (size_t i = 0; i < vertexCount(); ++i) {
+        forEachNeighbour(i, [&](size_t j, ValueType) {
+          size_t first  = find(i);
+          size_t second = find(j);
+          if (first == second) {
+            return;
+          }
+          if (sizes[first] < sizes[second]) {
+            std::swap(first, second);
+          }
+          parents[second]  = first;
+          sizes[first]    += sizes[second];
+        });
+      }
+      for (size_t i = 0; i < parents.size(); ++i) {
+        parents[i] = find(i);
+      }
+      return labelComponents(parents);
+    }
 
-        auto kluster_size = static_cast<size_t>(
-            std::ranges::count_if(vec_temp, [](size_t a) { return a > 0; }));
+    // lock-free hooking of the bigger root under the smaller one followed by
+    // pointer jumping (Shiloach-Vishkin / Afforest link and compress)
+    [[nodiscard]] ComponentLabels
+    getComponents(ParallelFlag) const
+    {
+      prepareAdjacency();
+      constexpr size_t kChunkSize{1024};
 
-        kluster_size_final = kluster_size > kluster_size_final
-                                 ? kluster_size
-                                 : kluster_size_final;
-        it                 = std::ranges::find(vec, 0);
+      size_t vertex_count = vertexCount();
+      std::vector<std::atomic<size_t>> parents(vertex_count);
+      for (size_t i = 0; i < vertex_count; ++i) {
+        parents[i].store(i, std::memory_order_relaxed);
       }
 
-      return kluster_size_final;
+      auto link = [&parents](size_t first, size_t second) {
+        size_t first_parent  = parents[first].load(std::memory_order_relaxed);
+        size_t second_parent = parents[second].load(std::memory_order_relaxed);
+        while (first_parent != second_parent) {
+          size_t high        = std::max(first_parent, second_parent);
+          size_t low         = std::min(first_parent, second_parent);
+          size_t high_parent = parents[high].load(std::memory_order_relaxed);
+          if (high_parent == low) {
+            break;
+          }
+          if (high_parent == high &&
+              parents[high].compare_exchange_strong(high_parent, low)) {
+            break;
+          }
+          first_parent  = parents[parents[high].load()].load();
+          second_parent = parents[low].load();
+        }
+      };
+      auto compress = [&parents](size_t vertex) {
+        while (parents[vertex].load(std::memory_order_relaxed) !=
+               parents[parents[vertex].load(std::memory_order_relaxed)].load(
+                   std::memory_order_relaxed)) {
+          parents[vertex].store(
+              parents[parents[vertex].load(std::memory_order_relaxed)].load(
+                  std::memory_order_relaxed),
+              std::memory_order_relaxed);
+        }
+      };
+
+      parallelFor(vertex_count, kChunkSize, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          forEachNeighbour(i, [&](size_t j, ValueType) { link(i, j); });
+        }
+      });
+      parallelFor(vertex_count, kChunkSize, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          compress(i);
+        }
+      });
+
+      std::vector<size_t> roots(vertex_count);
+      for (size_t i = 0; i < vertex_count; ++i) {
+        roots[i] = parents[i].load(std::memory_order_relaxed);
+      }
+      return labelComponents(roots);
     }
 
     double
@@ -1040,37 +3033,60 @@ namespace graph_first {
 
       if constexpr (kIsOriented) {
         return (static_cast<double>(edges_n) /
-                static_cast<double>(_matrix.size() * (_matrix.size() - 1)));
+                static_cast<double>(vertexCount() * (vertexCount() - 1)));
       }
       return (2 * static_cast<double>(edges_n) /
-              static_cast<double>(_matrix.size() * (_matrix.size() - 1)));
+              static_cast<double>(vertexCount() * (vertexCount() - 1)));
     }
 
+    // dense export of getSparseIncidenceMatrix, V rows of E cells
     IncidenceMatrix
     getIncidenceMatrix() const
     {
-      size_t i_size                                = _matrix.size();
-      std::vector<std::pair<size_t, size_t>> edges = getEdges();
-      size_t j_size                                = edges.size();
+      using cell_type = std::ranges::range_value_t<
+          std::ranges::range_value_t<IncidenceMatrix>>;
+      auto sparse = getSparseIncidenceMatrix();
+
       IncidenceMatrix result_matrix{};
       if constexpr (kResizable) {
-        result_matrix.resize(i_size);
+        result_matrix.resize(sparse.rows());
       }
-
-      for (size_t i = 0; i < i_size; ++i) {
-        result_matrix[i].resize(j_size);
-        for (size_t j = 0; j < j_size; ++j) {
-          if (edges[j].second == i) {
-            result_matrix[i][j] = 1;
-          }
-          else if (edges[j].first == i) {
-            result_matrix[i][j] = -1;
-          }
+      for (size_t i = 0; i < result_matrix.size(); ++i) {
+        result_matrix[i].resize(sparse.columns());
+      }
+      for (size_t i = 0; i < sparse.rows(); ++i) {
+        auto edges  = sparse.row(i);
+        auto values = sparse.rowValues(i);
+        for (size_t k = 0; k < edges.size(); ++k) {
+          result_matrix[i][edges[k]] = static_cast<cell_type>(values[k]);
         }
       }
 
       return result_matrix;
     }
+    // columns follow getEdges, or the list order for edges lists
+    [[nodiscard]] SparseIncidenceMatrix
+    getSparseIncidenceMatrix() const
+    {
+      prepareAdjacency();
+      SparseIncidenceMatrix result{};
+      if constexpr (std::is_same_v<ContainerTag, EdgesListTag>) {
+        for (const auto& edge : _matrix) {
+          result.addEdge(edge._startNode, edge._endNode);
+        }
+      }
+      else {
+        for (size_t i = 0; i < vertexCount(); ++i) {
+          forEachNeighbour(i, [&result, i](size_t j, ValueType) {
+            if (kIsOriented || j >= i) {
+              result.addEdge(i, j);
+            }
+          });
+        }
+      }
+      result.buildRows(vertexCount());
+      return result;
+    }
     /* DegreeMatrix
      getDegreeMatrix() const
      {
@@ -1099,11 +3115,13 @@ namespace graph_first {
        return result_matrix;
      }
      */
+    // square matrix with the degree sequence on the diagonal, kept for
+    // callers that want the matrix form; use getDegreeSequence otherwise
     DegreeMatrix
     getDegreeMatrix() const
     {
-      size_t i_size = _matrix.size();
-      size_t j_size = _matrix[0].size();
+      auto degrees  = getDegreeSequence();
+      size_t i_size = degrees.size();
 
       DegreeMatrix result_matrix{};
       if constexpr (kResizable) {
@@ -1111,20 +3129,62 @@ namespace graph_first {
       }
       for (size_t i = 0; i < i_size; ++i) {
         if constexpr (kResizable) {
-          result_matrix[i].resize(j_size);
-        }
-        for (size_t j = 0; j < j_size; ++j) {
-          result_matrix[i][i] += std::max(_matrix[i][j], _matrix[j][i]);
+          result_matrix[i].resize(i_size);
         }
+        result_matrix[i][i] = static_cast<unsigned_value_type>(degrees[i]);
       }
 
       return result_matrix;
     }
+    [[nodiscard]] DegreeSequence
+    getDegreeSequence() const
+    {
+      size_t i_size = vertexCount();
+
+      DegreeSequence result{std::vector<uint64_t>(i_size, 0)};
+      if constexpr (kIsBitMatrix) {
+        // max(a[i][j], a[j][i]) summed over j is popcount(row i | column i)
+        ContainerType transposed{};
+        if constexpr (kIsOriented) {
+          transposed = _matrix.transposed();
+        }
+        const ContainerType& columns = kIsOriented ? transposed : _matrix;
+        for (size_t i = 0; i < i_size; ++i) {
+          auto row    = _matrix[i].words();
+          auto column = columns[i].words();
+          for (size_t w = 0; w < row.size(); ++w) {
+            result._degrees[i] +=
+                static_cast<uint64_t>(std::popcount(row[w] | column[w]));
+          }
+        }
+      }
+      else if constexpr (std::is_same_v<ContainerTag, AdjacencyMatrixTag>) {
+        for (size_t i = 0; i < i_size; ++i) {
+          uint64_t degree{};
+          for (size_t j = 0; j < i_size; ++j) {
+            degree += static_cast<uint64_t>(
+                static_cast<unsigned_value_type>(
+                    std::max(_matrix[i][j], _matrix[j][i])));
+          }
+          result._degrees[i] = degree;
+        }
+      }
+      else {
+        forEachSymmetricNeighbour(
+            [&result](size_t i, size_t, ValueType value) {
+              result._degrees[i] += static_cast<uint64_t>(
+                  static_cast<unsigned_value_type>(value));
+            });
+      }
+
+      return result;
+    }
     ReachabilityMatrix
     getReachabilityMatrix() const
     {
-      size_t i_size = _matrix.size();
-      size_t j_size = _matrix[0].size();
+      size_t i_size = vertexCount();
+      size_t j_size = i_size;
+      auto reachable = getReachabilityBits();
 
       ReachabilityMatrix result_matrix{};
       if constexpr (kResizable) {
@@ -1134,18 +3194,125 @@ namespace graph_first {
         if constexpr (kResizable) {
           result_matrix[i].resize(j_size);
         }
-        for (size_t j = 0; j < j_size; ++j) {
-          result_matrix[i][j] = i == j ? 1 : isReachable(i, j);
-        }
+        reachable.forEachSet(i, [&result_matrix, i](size_t j) {
+          result_matrix[i][j] = 1;
+        });
       }
 
       return result_matrix;
     }
+
+    // transitive closure: strongly connected components are found with tarjan,
+    // which emits them sinks first, so every component ORs the already
+    // finished rows of its successors word by word
+    [[nodiscard]] BitMatrix<NodeAmount>
+    getReachabilityBits() const
+    {
+      using word_type = typename BitMatrix<NodeAmount>::word_type;
+      constexpr size_t kWordBits{BitMatrix<NodeAmount>::kWordBits};
+      constexpr size_t kNone = std::numeric_limits<size_t>::max();
+
+      auto adjacency      = getCsr();
+      size_t vertex_count = adjacency.size();
+
+      std::vector<size_t> components(vertex_count, kNone);
+      std::vector<size_t> order(vertex_count, kNone);
+      std::vector<size_t> low(vertex_count);
+      std::vector<size_t> stack;
+      std::vector<std::pair<size_t, size_t>> call_stack;
+      size_t next_order{};
+      size_t component_count{};
+
+      for (size_t source = 0; source < vertex_count; ++source) {
+        if (order[source] != kNone) {
+          continue;
+        }
+        order[source] = low[source] = next_order++;
+        stack.push_back(source);
+        call_stack.emplace_back(source, adjacency._offsets[source]);
+
+        while (!call_stack.empty()) {
+          auto& [vertex, edge] = call_stack.back();
+          if (edge != adjacency._offsets[vertex + 1]) {
+            size_t next = adjacency._neighbours[edge++];
+            if (order[next] == kNone) {
+              order[next] = low[next] = next_order++;
+              stack.push_back(next);
+              call_stack.emplace_back(next, adjacency._offsets[next]);
+            }
+            else if (components[next] == kNone) {
+              low[vertex] = std::min(low[vertex], order[next]);
+            }
+            continue;
+          }
+
+          size_t finished = vertex;
+          call_stack.pop_back();
+          if (!call_stack.empty()) {
+            size_t parent = call_stack.back().first;
+            low[parent]   = std::min(low[parent], low[finished]);
+          }
+          if (low[finished] != order[finished]) {
+            continue;
+          }
+          size_t member = kNone;
+          while (member != finished) {
+            member             = stack.back();
+            components[member] = component_count;
+            stack.pop_back();
+          }
+          component_count++;
+        }
+      }
+
+      BitMatrix<NodeAmount> result{};
+      if constexpr (kResizable) {
+        result.resize(vertex_count);
+      }
+      size_t row_words = result.rowWords();
+
+      std::vector<std::vector<size_t>> members(component_count);
+      for (size_t i = 0; i < vertex_count; ++i) {
+        members[components[i]].push_back(i);
+      }
+
+      std::vector<word_type> component_rows(component_count * row_words);
+      std::vector<size_t> last_merged(component_count, kNone);
+      for (size_t c = 0; c < component_count; ++c) {
+        auto row = std::span<word_type>{component_rows}.subspan(c * row_words,
+                                                                row_words);
+        for (size_t vertex : members[c]) {
+          row[vertex / kWordBits] |= word_type{1} << (vertex % kWordBits);
+        }
+        for (size_t vertex : members[c]) {
+          for (size_t next : adjacency.neighbours(vertex)) {
+            size_t next_component = components[next];
+            if (next_component == c || last_merged[next_component] == c) {
+              continue;
+            }
+            last_merged[next_component] = c;
+            const word_type* next_row =
+                component_rows.data() + (next_component * row_words);
+            for (size_t w = 0; w < row_words; ++w) {
+              row[w] |= next_row[w];
+            }
+          }
+        }
+      }
+
+      for (size_t i = 0; i < vertex_count; ++i) {
+        std::ranges::copy(std::span<const word_type>{component_rows}.subspan(
+                              components[i] * row_words, row_words),
+                          result[i].words().begin());
+      }
+      return result;
+    }
+
     DistanceMatrix
     getDistanceMatrix() const
     {
-      size_t i_size = _matrix.size();
-      size_t j_size = _matrix[0].size();
+      size_t i_size = vertexCount();
+      size_t j_size = i_size;
 
       DistanceMatrix result_matrix{};
       if constexpr (kResizable) {
@@ -1155,8 +3322,10 @@ namespace graph_first {
         if constexpr (kResizable) {
           result_matrix[i].resize(j_size);
         }
+        auto distances = getDistances(i);
         for (size_t j = 0; j < j_size; ++j) {
-          result_matrix[i][j] = i == j ? 0 : djkstra(i, j);
+          result_matrix[i][j] =
+              static_cast<signed_value_type>(toDistanceValue(distances[j]));
         }
       }
 
@@ -1190,9 +3359,76 @@ namespace graph_first {
       return result_matrix;
     }
 
+    // sparse form of the kirchoff matrix for spectral work on large graphs:
+    // w_ij = max(a[i][j], a[j][i]) and loops dropped, so rows sum to zero.
+    // Throws std::invalid_argument on a negative weight, the spectral
+    // routines rely on L being positive semidefinite
+    [[nodiscard]] spectral::SparseLaplacian
+    getSparseLaplacian() const
+    {
+      if constexpr (std::is_signed_v<ValueType>) {
+        prepareAdjacency();
+        for (size_t i = 0; i < vertexCount(); ++i) {
+          forEachNeighbour(i, [](size_t, ValueType value) {
+            if (value < ValueType{}) {
+              throw std::invalid_argument("negative edge weight in laplacian");
+            }
+          });
+        }
+      }
+      spectral::SparseLaplacian result{};
+      result._offsets.assign(vertexCount() + 1, 0);
+      result._diagonal.assign(vertexCount(), 0.0);
+      forEachSymmetricNeighbour(
+          [&result](size_t i, size_t j, ValueType value) {
+            if (i == j) {
+              return;
+            }
+            auto weight = static_cast<double>(value);
+            result._neighbours.push_back(j);
+            result._weights.push_back(weight);
+            result._diagonal[i] += weight;
+            ++result._offsets[i + 1];
+          });
+      std::partial_sum(result._offsets.begin(), result._offsets.end(),
+                       result._offsets.begin());
+      return result;
+    }
+    // algebraic connectivity and fiedler vector, see spectral::fiedlerPair
+    [[nodiscard]] spectral::FiedlerPair
+    getFiedlerPair(double tolerance     = spectral::kTolerance,
+                   size_t max_iterations = spectral::kMaxIterations) const
+    {
+      return spectral::fiedlerPair(getSparseLaplacian(), tolerance,
+                                   max_iterations);
+    }
+    [[nodiscard]] double
+    getAlgebraicConnectivity() const
+    {
+      return getFiedlerPair()._value;
+    }
+    // estimated ln of the spanning tree count, see spectral::logSpanningTrees
+    [[nodiscard]] double
+    getLogSpanningTrees(size_t probes = spectral::kProbes,
+                        size_t steps  = spectral::kLanczosSteps) const
+    {
+      return spectral::logSpanningTrees(getSparseLaplacian(), probes, steps);
+    }
+
+    // single-source dijkstra, fills the whole row of distances from source,
+    // kUnreachable marks vertexes without a path
+    [[nodiscard]] std::vector<uint64_t>
+    getDistances(size_t source) const
+    {
+      prepareAdjacency();
+      return dijkstraRow(source, vertexCount());
+    }
+
     ContainerType&
     getMatrix()
     {
+      _incidence._valid = false;
+      _reverse._valid   = false;
       return _matrix;
     }
     const ContainerType&
@@ -1229,28 +3465,68 @@ namespace graph_first {
     getNeighbours<EdgesListTag>(size_t idx)
     {
       std::vector<std::pair<std::string_view, size_t>> res;
-      std::set<size_t> picked_neighbours;
-
-      for (auto& i : _matrix) {
-        bool start = idx == i._startNode;
-        if (start || idx == i._endNode) {
-          auto idx_to_push = start ? i._endNode : i._startNode;
-
-          res.emplace_back("v", idx_to_push);
-          picked_neighbours.insert(idx_to_push);
+      const auto& incidence = getIncidence();
+      auto out_edges        = incidence.outEdges(idx);
+      auto in_edges         = incidence.inEdges(idx);
+
+      // both groups are ordered by edge id, merging them keeps list order and
+      // reports a loop once
+      size_t o{};
+      size_t n{};
+      while (o < out_edges.size() || n < in_edges.size()) {
+        bool out = n == in_edges.size() ||
+                   (o < out_edges.size() && out_edges[o] <= in_edges[n]);
+        if (out) {
+          if (n < in_edges.size() && in_edges[n] == out_edges[o]) {
+            ++n;
+          }
+          res.emplace_back("v", _matrix[out_edges[o++]]._endNode);
+        }
+        else {
+          res.emplace_back("v", _matrix[in_edges[n++]]._startNode);
         }
       }
       return res;
     }
+    template <>
+    [[nodiscard]] std::vector<std::pair<std::string_view, size_t>>
+    getNeighbours<AdjacencyListTag>(size_t idx)
+    {
+      std::vector<std::pair<std::string_view, size_t>> res;
+      auto name = [this](size_t i) -> std::string_view {
+        return i < _matrix_names.size() ? std::string_view{_matrix_names[i]}
+                                        : "v";
+      };
+      for (const auto& [neighbour, value] : _matrix[idx]) {
+        if (neighbour != idx) {
+          res.emplace_back(name(neighbour), neighbour);
+        }
+      }
+      if constexpr (kIsOriented) {
+        // both the row and the sources are sorted, one merge skips the
+        // vertexes already reported as out-neighbours
+        const auto& row = _matrix[idx];
+        auto out        = row.begin();
+        for (size_t i : getReverseAdjacency().sources(idx)) {
+          while (out != row.end() && out->first < i) {
+            ++out;
+          }
+          if (i != idx && (out == row.end() || out->first != i)) {
+            res.emplace_back(name(i), i);
+          }
+        }
+      }
+      return res;
+    }
+
     template <>
     [[nodiscard]] std::vector<std::pair<std::string_view, size_t>>
     getNeighbours<NodeListTag>(size_t idx)
     {
       std::vector<std::pair<std::string_view, size_t>> res;
-      std::set<size_t> picked_neighbours;
-      for (auto& negh : _matrix[idx]._neighbours) {
-        res.emplace_back(_matrix[negh]._name, negh);
-        picked_neighbours.insert(negh);
+      _matrix.normalize();
+      for (size_t negh : _matrix.neighbours(idx)) {
+        res.emplace_back(_matrix.name(negh), negh);
       }
 
       return res;
@@ -1274,6 +3550,50 @@ namespace graph_first {
    private:
     ContainerType _matrix{};
     NameContainerType _matrix_names{};
+    // EdgesListTag only, built on first neighbourhood query
+    mutable EdgeIncidence _incidence{};
+    // oriented AdjacencyListTag only, built on first getNeighbours
+    mutable ReverseAdjacency _reverse{};
+
+    void
+    checkVertex(size_t vertex_index) const
+    {
+      if (vertex_index >= _matrix.size()) {
+        throw std::out_of_range("vertex index out of range");
+      }
+    }
+
+    // not thread safe on first call, build it before spawning workers
+    const EdgeIncidence&
+    getIncidence() const
+    {
+      if (!_incidence._valid) {
+        _incidence.build(_matrix);
+      }
+      return _incidence;
+    }
+    // not thread safe on first call either
+    const ReverseAdjacency&
+    getReverseAdjacency() const
+    {
+      if (!_reverse._valid) {
+        _reverse.build(_matrix);
+      }
+      return _reverse;
+    }
+    // builds the lazy indexes forEachNeighbour reads. Public entry points
+    // call it before spawning workers, forEachNeighbour itself stays read
+    // only; on prepared indexes it doesn't write
+    void
+    prepareAdjacency() const
+    {
+      if constexpr (std::is_same_v<ContainerTag, NodeListTag>) {
+        _matrix.normalize();
+      }
+      else if constexpr (std::is_same_v<ContainerTag, EdgesListTag>) {
+        getIncidence();
+      }
+    }
 
     size_t
     getEdgesNumber()
@@ -1283,74 +3603,820 @@ namespace graph_first {
     [[nodiscard]] std::vector<std::pair<size_t, size_t>>
     getEdges() const
     {
+      prepareAdjacency();
       std::vector<std::pair<size_t, size_t>> edges{};
-      for (size_t i = 0; i != _matrix.size(); ++i) {
-        size_t j = i;
-        if constexpr (kIsOriented) {
-          j = 0;
-        }
-        for (; j != _matrix[0].size(); ++j) {
-          if (_matrix[i][j] != 0) {
+      for (size_t i = 0; i != vertexCount(); ++i) {
+        forEachNeighbour(i, [&edges, i](size_t j, ValueType) {
+          if (kIsOriented || j >= i) {
             edges.emplace_back(i, j);
           }
-        }
+        });
       }
       return edges;
     }
-    unsigned_value_type
-    djkstra(size_t first_node_index, size_t second_node_index) const
+
+    // every edge adds its weight at both ends. Dense rows are summed in one
+    // row-major pass, oriented matrices gather the column sums in the same
+    // pass instead of walking columns
+    template <bool Weighted>
+    [[nodiscard]] std::vector<uint64_t>
+    incidentSums() const
     {
-      if (first_node_index == second_node_index) {
-        return 0;
+      prepareAdjacency();
+      auto weight = [](ValueType value) -> uint64_t {
+        if constexpr (Weighted) {
+          return static_cast<uint64_t>(value);
+        }
+        else {
+          return value != 0 ? 1 : 0;
+        }
+      };
+
+      std::vector<uint64_t> result(vertexCount(), 0);
+      if constexpr (std::is_same_v<ContainerTag, EdgesListTag>) {
+        for (const auto& edge : _matrix) {
+          result[edge._startNode] += weight(edge._value);
+          result[edge._endNode]   += weight(edge._value);
+        }
       }
-      VisitedMatrix visited{};
-      if constexpr (kResizable) {
-        visited.resize(_matrix.size());
+      else if constexpr (std::is_same_v<ContainerTag, NodeListTag>) {
+        for (size_t i = 0; i < _matrix.size(); ++i) {
+          for (const auto& edge : _matrix.edges(i)) {
+            result[i]          += weight(edge._value);
+            result[edge._node] += weight(edge._value);
+          }
+        }
+      }
+      else if constexpr (std::is_same_v<ContainerTag, AdjacencyMatrixTag>) {
+        size_t vertex_count = result.size();
+        std::vector<uint64_t> columns(kIsOriented ? vertex_count : 0, 0);
+        for (size_t i = 0; i < vertex_count; ++i) {
+          const auto& row = _matrix[i];
+          uint64_t sum{};
+          for (size_t j = 0; j < vertex_count; ++j) {
+            sum += weight(row[j]);
+          }
+          if constexpr (kIsOriented) {
+            for (size_t j = 0; j < vertex_count; ++j) {
+              columns[j] += weight(row[j]);
+            }
+          }
+          else {
+            sum += weight(row[i]);
+          }
+          result[i] = sum;
+        }
+        for (size_t i = 0; i < columns.size(); ++i) {
+          result[i] += columns[i];
+        }
+      }
+      else {
+        for (size_t i = 0; i < result.size(); ++i) {
+          forEachNeighbour(i, [&result, &weight, i](size_t j, ValueType value) {
+            result[i] += weight(value);
+            if (kIsOriented || j == i) {
+              result[j] += weight(value);
+            }
+          });
+        }
+      }
+      return result;
+    }
+
+    // largest number of list entries touching one vertex, a loop counts twice
+    [[nodiscard]] size_t
+    maxIncidentEdges() const
+    {
+      const auto& incidence = getIncidence();
+      size_t result{};
+      for (size_t i = 0; i < incidence.size(); ++i) {
+        result = std::max(result, incidence.outEdges(i).size() +
+                                      incidence.inEdges(i).size());
       }
-      visited[first_node_index] = true;
+      return result;
+    }
 
-      WeightsMatrix weights{};
+    // edges lists do not store vertexes, they are counted by the incidence
+    // index
+    [[nodiscard]] size_t
+    vertexCount() const
+    {
+      if constexpr (std::is_same_v<ContainerTag, EdgesListTag>) {
+        return getIncidence().size();
+      }
+      else {
+        return _matrix.size();
+      }
+    }
 
-      if constexpr (kResizable) {
-        weights.resize(_matrix.size());
+    // function(i, j, max(a[i][j], a[j][i])) once per vertex i and distinct
+    // neighbour j in either direction, i increasing. A scratch row cleared by
+    // the touched list keeps it O(V + E): rows need not be sorted and
+    // parallel list edges collapse to the heaviest one. Zero entries are
+    // skipped
+    template <typename Function>
+    void
+    forEachSymmetricNeighbour(Function&& function) const
+    {
+      auto out_edges = getCsr();
+      CsrStorage<ValueType> in_edges{};
+      if constexpr (kIsOriented) {
+        in_edges = transposeCsr(out_edges);
+      }
+      size_t vertex_count = out_edges.size();
+
+      std::vector<ValueType> best(vertex_count, ValueType{});
+      std::vector<size_t> touched;
+      auto touch = [&](size_t j, ValueType value) {
+        if (best[j] == ValueType{}) {
+          touched.push_back(j);
+        }
+        best[j] = std::max(best[j], value);
+      };
+      auto visit = [&](const CsrStorage<ValueType>& csr, size_t i) {
+        for (size_t k = csr._offsets[i]; k < csr._offsets[i + 1]; ++k) {
+          touch(csr._neighbours[k], csr._values[k]);
+        }
+      };
+      for (size_t i = 0; i < vertex_count; ++i) {
+        visit(out_edges, i);
+        if constexpr (kIsOriented) {
+          visit(in_edges, i);
+        }
+        if constexpr (std::is_same_v<ContainerTag, NodeListTag> &&
+                      !kIsOriented) {
+          // undirected node lists keep loops out of the neighbour rows
+          if (const auto* loop = _matrix.findEdge(i, i); loop != nullptr) {
+            touch(i, loop->_value);
+          }
+        }
+        for (size_t j : touched) {
+          if (best[j] != ValueType{}) {
+            function(i, j, best[j]);
+            best[j] = ValueType{};
+          }
+        }
+        touched.clear();
+      }
+    }
+
+    // calls function(neighbour, value) for every outgoing edge of vertex
+    template <typename Function>
+    void
+    forEachNeighbour(size_t vertex, Function&& function) const
+    {
+      if constexpr (std::is_same_v<ContainerTag, CsrTag>) {
+        for (size_t k = _matrix._offsets[vertex];
+             k != _matrix._offsets[vertex + 1]; ++k) {
+          function(_matrix._neighbours[k], _matrix._values[k]);
+        }
+      }
+      else if constexpr (kIsBitMatrix) {
+        _matrix.forEachSet(vertex,
+                           [&function](size_t j) { function(j, ValueType{1}); });
+      }
+      else if constexpr (std::is_same_v<ContainerTag, AdjacencyListTag>) {
+        for (const auto& [neighbour, value] : _matrix[vertex]) {
+          function(neighbour, value);
+        }
+      }
+      else if constexpr (std::is_same_v<ContainerTag, NodeListTag>) {
+        assert(!_matrix.dirty());
+        if constexpr (kIsOriented) {
+          for (const auto& edge : _matrix.edges(vertex)) {
+            function(edge._node, edge._value);
+          }
+        }
+        else {
+          for (size_t neighbour : _matrix.neighbours(vertex)) {
+            const auto* edge = _matrix.findEdge(vertex, neighbour);
+            if (edge == nullptr) {
+              edge = _matrix.findEdge(neighbour, vertex);
+            }
+            function(neighbour, edge->_value);
+          }
+        }
+      }
+      else if constexpr (std::is_same_v<ContainerTag, EdgesListTag>) {
+        assert(_incidence._valid);
+        const auto& incidence = _incidence;
+        for (size_t edge : incidence.outEdges(vertex)) {
+          function(_matrix[edge]._endNode, _matrix[edge]._value);
+        }
+        if constexpr (!kIsOriented) {
+          for (size_t edge : incidence.inEdges(vertex)) {
+            if (_matrix[edge]._startNode != vertex) {
+              function(_matrix[edge]._startNode, _matrix[edge]._value);
+            }
+          }
+        }
+      }
+      else {
+        const auto& row = _matrix[vertex];
+        for (size_t j = 0; j < row.size(); ++j) {
+          if (row[j] != 0) {
+            function(j, row[j]);
+          }
+        }
+      }
+    }
+
+    [[nodiscard]] ValueType
+    getEdgeValue(size_t first_node, size_t second_node) const
+    {
+      if constexpr (std::is_same_v<ContainerTag, CsrTag>) {
+        auto row = _matrix.neighbours(first_node);
+        auto it  = std::ranges::lower_bound(row, second_node);
+        if (it == row.end() || *it != second_node) {
+          return 0;
+        }
+        return _matrix._values[_matrix._offsets[first_node] +
+                               static_cast<size_t>(it - row.begin())];
+      }
+      else if constexpr (std::is_same_v<ContainerTag, AdjacencyListTag>) {
+        const auto& row = _matrix[first_node];
+        auto it         = findAdjacencyEntry(row, second_node);
+        return it == row.end() || it->first != second_node ? ValueType{}
+                                                           : it->second;
+      }
+      else {
+        return _matrix[first_node][second_node];
       }
+    }
+    // visits a whole row word at a time: row & ~visited gives the new layer
+    std::vector<size_t>
+    bfsBits(size_t start) const
+    {
+      using word_type = typename ContainerType::word_type;
+      constexpr size_t kWordBits{ContainerType::kWordBits};
+
+      std::vector<word_type> visited(_matrix.rowWords());
+      std::vector<size_t> res(_matrix.size());
+      std::queue<size_t> q;
+
+      q.push(start);
+      visited[start / kWordBits] |= word_type{1} << (start % kWordBits);
+
+      while (!q.empty()) {
+        size_t current = q.front();
+        q.pop();
 
-      for (auto& i : weights) {
-        i = kNodeValueMax;
+        auto row = _matrix[current].words();
+        for (size_t w = 0; w < row.size(); ++w) {
+          word_type next  = row[w] & ~visited[w];
+          visited[w]     |= next;
+          for (; next != 0; next &= next - 1) {
+            size_t i = (w * kWordBits) + static_cast<size_t>(std::countr_zero(next));
+            res[i]   = res[current] + 1;
+            q.push(i);
+          }
+        }
       }
 
-      weights[first_node_index] = 0;
+      return res;
+    }
+
+    // bit k of seen/visit words belongs to sources[k]
+    template <typename Visitor>
+    static void
+    multiSourceBfsBatch(const CsrStorage<ValueType>& adjacency,
+                        std::span<const size_t> sources, Visitor&& visitor)
+    {
+      using word_type = uint64_t;
 
-      size_t current_node       = first_node_index;
+      size_t vertex_count = adjacency.size();
+      std::vector<word_type> seen(vertex_count);
+      std::vector<word_type> visit(vertex_count);
+      std::vector<word_type> visit_next(vertex_count);
 
-      while (current_node != second_node_index) {
-        for (size_t i = 0; i < weights.size(); ++i) {
-          if (visited[i] || _matrix[current_node][i] == 0) {
+      for (size_t k = 0; k < sources.size(); ++k) {
+        seen[sources[k]]  |= word_type{1} << k;
+        visit[sources[k]] |= word_type{1} << k;
+        visitor(k, sources[k], uint64_t{0});
+      }
+
+      for (uint64_t depth = 1;; ++depth) {
+        for (size_t i = 0; i < vertex_count; ++i) {
+          if (visit[i] == 0) {
             continue;
           }
-          ValueType new_value =
-              weights[current_node] + _matrix[current_node][i];
+          for (size_t next : adjacency.neighbours(i)) {
+            visit_next[next] |= visit[i];
+          }
+        }
 
-          weights[i] = std::min(weights[i], new_value);
+        bool found = false;
+        for (size_t i = 0; i < vertex_count; ++i) {
+          word_type discovered  = visit_next[i] & ~seen[i];
+          visit_next[i]         = 0;
+          visit[i]              = discovered;
+          seen[i]              |= discovered;
+          found                 = found || discovered != 0;
+          for (; discovered != 0; discovered &= discovered - 1) {
+            visitor(static_cast<size_t>(std::countr_zero(discovered)), i,
+                    depth);
+          }
+        }
+        if (!found) {
+          return;
+        }
+      }
+    }
+
+    static size_t
+    hardwareThreads()
+    {
+      return std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    // hands out [begin, end) chunks of [0, count) to at most hardwareThreads()
+    // workers, body(thread_idx, begin, end); the calling thread is worker 0
+    template <typename Body>
+    static void
+    parallelFor(size_t count, size_t chunk_size, Body&& body)
+    {
+      size_t chunk_count  = (count + chunk_size - 1) / chunk_size;
+      size_t thread_count = std::min(hardwareThreads(), chunk_count);
+      std::atomic<size_t> next_chunk{};
+
+      auto worker         = [&](size_t thread_idx) {
+        for (size_t begin = next_chunk.fetch_add(chunk_size); begin < count;
+             begin        = next_chunk.fetch_add(chunk_size)) {
+          body(thread_idx, begin, std::min(begin + chunk_size, count));
         }
-        int64_t min_weight_index = -1;
-        ValueType min_value      = kNodeValueMax;
+      };
+      if (thread_count <= 1) {
+        worker(0);
+        return;
+      }
+      std::vector<std::jthread> threads;
+      threads.reserve(thread_count - 1);
+      for (size_t t = 1; t < thread_count; ++t) {
+        threads.emplace_back(worker, t);
+      }
+      worker(0);
+    }
+
+    static CsrStorage<ValueType>
+    transposeCsr(const CsrStorage<ValueType>& csr)
+    {
+      CsrStorage<ValueType> result{};
+      result._offsets.assign(csr._offsets.size(), 0);
+      for (size_t neighbour : csr._neighbours) {
+        result._offsets[neighbour + 1]++;
+      }
+      for (size_t i = 1; i < result._offsets.size(); ++i) {
+        result._offsets[i] += result._offsets[i - 1];
+      }
+      result._neighbours.resize(csr._neighbours.size());
+      result._values.resize(csr._values.size());
+      std::vector<size_t> position(result._offsets.begin(),
+                                   result._offsets.end() - 1);
+      for (size_t i = 0; i < csr.size(); ++i) {
+        for (size_t k = csr._offsets[i]; k != csr._offsets[i + 1]; ++k) {
+          size_t to                 = position[csr._neighbours[k]]++;
+          result._neighbours[to]    = i;
+          result._values[to]        = csr._values[k];
+        }
+      }
+      return result;
+    }
+
+    // snapshot of the outgoing edges in csr form
+    [[nodiscard]] CsrStorage<ValueType>
+    getCsr() const
+    {
+      prepareAdjacency();
+      if constexpr (std::is_same_v<ContainerTag, CsrTag>) {
+        return _matrix;
+      }
+      else {
+        CsrStorage<ValueType> result{};
+        size_t vertex_count = vertexCount();
+        result._offsets.reserve(vertex_count + 1);
+        result._offsets.push_back(0);
+        for (size_t i = 0; i < vertex_count; ++i) {
+          forEachNeighbour(i, [&result](size_t j, ValueType value) {
+            result._neighbours.push_back(j);
+            result._values.push_back(value);
+          });
+          result._offsets.push_back(result._neighbours.size());
+        }
+        return result;
+      }
+    }
 
-        for (size_t i = 0; i < weights.size(); ++i) {
-          if (min_value > weights[i] && !visited[i]) {
-            min_value        = weights[i];
-            min_weight_index = static_cast<int64_t>(i);
+    // galloping search: doubles the window from the front before the binary
+    // search, so lookups near the start of long rows stay cheap
+    static auto
+    findAdjacencyEntry(auto& row, size_t neighbour)
+    {
+      size_t bound{1};
+      while (bound < row.size() && row[bound - 1].first < neighbour) {
+        bound *= 2;
+      }
+      return std::lower_bound(
+          row.begin() + static_cast<int64_t>(bound / 2),
+          row.begin() + static_cast<int64_t>(std::min(bound, row.size())),
+          neighbour,
+          [](const auto& entry, size_t value) { return entry.first < value; });
+    }
+
+    void
+    insertAdjacencyEntry(size_t first_node, size_t second_node, ValueType value)
+    {
+      _reverse._valid = false;
+      auto& row       = _matrix[first_node];
+      auto it   = findAdjacencyEntry(row, second_node);
+      if (it != row.end() && it->first == second_node) {
+        it->second = value;
+        return;
+      }
+      row.emplace(it, second_node, value);
+    }
+
+    // turns root of every vertex into dense component ids
+    static ComponentLabels
+    labelComponents(const std::vector<size_t>& roots)
+    {
+      constexpr size_t kNoLabel = std::numeric_limits<size_t>::max();
+
+      ComponentLabels result{};
+      result._labels.resize(roots.size());
+      std::vector<size_t> root_labels(roots.size(), kNoLabel);
+
+      for (size_t i = 0; i < roots.size(); ++i) {
+        size_t& label = root_labels[roots[i]];
+        if (label == kNoLabel) {
+          label = result._sizes.size();
+          result._sizes.push_back(0);
+        }
+        result._labels[i] = label;
+        if (++result._sizes[label] > result._sizes[result._giant]) {
+          result._giant = label;
+        }
+      }
+      return result;
+    }
+
+    // bfs levels as distances, buffers are reused between calls
+    void
+    hopDistances(size_t source, std::vector<uint64_t>& distances,
+                 std::vector<size_t>& queue) const
+    {
+      distances.assign(vertexCount(), kUnreachable);
+      queue.clear();
+
+      distances[source] = 0;
+      queue.push_back(source);
+      for (size_t head = 0; head < queue.size(); ++head) {
+        size_t current = queue[head];
+        forEachNeighbour(current, [&](size_t i, ValueType) {
+          if (distances[i] == kUnreachable) {
+            distances[i] = distances[current] + 1;
+            queue.push_back(i);
           }
+        });
+      }
+    }
+
+    // binary heap with lazy deletion, stops early once target is settled
+    [[nodiscard]] std::vector<uint64_t>
+    dijkstraRow(size_t source, size_t target) const
+    {
+      using queue_entry = std::pair<uint64_t, size_t>;
+
+      std::vector<uint64_t> distances(vertexCount(), kUnreachable);
+      std::priority_queue<queue_entry, std::vector<queue_entry>, std::greater<>>
+          queue;
+
+      distances[source] = 0;
+      queue.emplace(0, source);
+
+      while (!queue.empty()) {
+        auto [distance, current] = queue.top();
+        queue.pop();
+        if (distance != distances[current]) {
+          continue;
+        }
+        if (current == target) {
+          break;
         }
+        forEachNeighbour(current, [&](size_t i, ValueType value) {
+          uint64_t new_value = distance + static_cast<uint64_t>(value);
+          if (new_value < distances[i]) {
+            distances[i] = new_value;
+            queue.emplace(new_value, i);
+          }
+        });
+      }
+      return distances;
+    }
+
+    static utility::Generator<std::span<const size_t>>
+    simplePaths(CsrStorage<ValueType> csr, size_t source, size_t target)
+    {
+      if (source >= csr.size() || target >= csr.size()) {
+        co_return;
+      }
+      std::vector<bool> visited(csr.size(), false);
+      std::vector<size_t> path{source};
+      // next edge to try out of every vertex on the path
+      std::vector<size_t> next{csr._offsets[source]};
+      if (source == target) {
+        co_yield std::span<const size_t>{path};
+        co_return;
+      }
 
-        if (min_value == kNodeValueMax) {
-          return static_cast<unsigned_value_type>(kNodeValueMax);
+      visited[source] = true;
+      while (!path.empty()) {
+        size_t vertex = path.back();
+        if (next.back() == csr._offsets[vertex + 1]) {
+          visited[vertex] = false;
+          path.pop_back();
+          next.pop_back();
+          continue;
+        }
+        size_t neighbour = csr._neighbours[next.back()++];
+        if (visited[neighbour]) {
+          continue;
+        }
+        path.push_back(neighbour);
+        if (neighbour == target) {
+          co_yield std::span<const size_t>{path};
+          path.pop_back();
+          continue;
         }
+        visited[neighbour] = true;
+        next.push_back(csr._offsets[neighbour]);
+      }
+    }
+
+    // work stealing over dfs prefixes: a prefix shorter than kSplitDepth is
+    // expanded into one task per child on the owner's deque, owners pop the
+    // newest task and idle workers steal the oldest one from the others.
+    // Longer prefixes are finished by a plain dfs with the worker's own
+    // visited bitset and path stack
+    template <typename Sink>
+    static void
+    parallelPaths(const CsrStorage<ValueType>& csr, size_t source,
+                  size_t target, Sink& sink)
+    {
+      using word_type = uint64_t;
+      constexpr size_t kWordBits{std::numeric_limits<word_type>::digits};
+      constexpr size_t kSplitDepth{3};
 
-        current_node          = static_cast<size_t>(min_weight_index);
-        visited[current_node] = true;
+      if (source >= csr.size() || target >= csr.size()) {
+        return;
       }
-      return static_cast<unsigned_value_type>(weights[second_node_index]);
+      if (source == target) {
+        std::array<size_t, 1> path{source};
+        sink(size_t{}, std::span<const size_t>{path});
+        return;
+      }
+
+      struct TaskQueue {
+        std::mutex _lock;
+        std::deque<std::vector<size_t>> _tasks;
+      };
+      size_t thread_count = hardwareThreads();
+      std::vector<TaskQueue> queues(thread_count);
+      // tasks queued or running, children are counted before their parent
+      // is finished, so zero means the whole tree is done
+      std::atomic<size_t> pending{1};
+      queues[0]._tasks.push_back({source});
+
+      auto take = [&queues, thread_count](size_t thread_idx,
+                                          std::vector<size_t>& task) {
+        for (size_t k = 0; k < thread_count; ++k) {
+          auto& queue = queues[(thread_idx + k) % thread_count];
+          std::scoped_lock lock{queue._lock};
+          if (queue._tasks.empty()) {
+            continue;
+          }
+          if (k == 0) {
+            task = std::move(queue._tasks.back());
+            queue._tasks.pop_back();
+          }
+          else {
+            task = std::move(queue._tasks.front());
+            queue._tasks.pop_front();
+          }
+          return true;
+        }
+        return false;
+      };
+
+      auto worker = [&](size_t thread_idx) {
+        std::vector<word_type> visited((csr.size() + kWordBits - 1) /
+                                       kWordBits);
+        auto is_visited = [&](size_t vertex) {
+          return ((visited[vertex / kWordBits] >> (vertex % kWordBits)) & 1U) !=
+                 0;
+        };
+        auto flip = [&](size_t vertex) {
+          visited[vertex / kWordBits] ^= word_type{1} << (vertex % kWordBits);
+        };
+        std::vector<size_t> path;
+        std::vector<size_t> next;
+
+        while (pending.load(std::memory_order_acquire) != 0) {
+          if (!take(thread_idx, path)) {
+            std::this_thread::yield();
+            continue;
+          }
+          for (size_t vertex : path) {
+            flip(vertex);
+          }
+
+          if (path.size() < kSplitDepth) {
+            for (size_t neighbour : csr.neighbours(path.back())) {
+              if (is_visited(neighbour)) {
+                continue;
+              }
+              path.push_back(neighbour);
+              if (neighbour == target) {
+                sink(thread_idx, std::span<const size_t>{path});
+              }
+              else {
+                pending.fetch_add(1, std::memory_order_relaxed);
+                std::scoped_lock lock{queues[thread_idx]._lock};
+                queues[thread_idx]._tasks.push_back(path);
+              }
+              path.pop_back();
+            }
+          }
+          else {
+            size_t base = path.size();
+            next.assign(1, csr._offsets[path.back()]);
+            while (path.size() >= base) {
+              size_t vertex = path.back();
+              if (next.back() == csr._offsets[vertex + 1]) {
+                flip(vertex);
+                path.pop_back();
+                next.pop_back();
+                continue;
+              }
+              size_t neighbour = csr._neighbours[next.back()++];
+              if (is_visited(neighbour)) {
+                continue;
+              }
+              path.push_back(neighbour);
+              if (neighbour == target) {
+                sink(thread_idx, std::span<const size_t>{path});
+                path.pop_back();
+                continue;
+              }
+              flip(neighbour);
+              next.push_back(csr._offsets[neighbour]);
+            }
+          }
+
+          for (size_t vertex : path) {
+            flip(vertex);
+          }
+          pending.fetch_sub(1, std::memory_order_acq_rel);
+        }
+      };
+
+      std::vector<std::jthread> threads;
+      threads.reserve(thread_count - 1);
+      for (size_t t = 1; t < thread_count; ++t) {
+        threads.emplace_back(worker, t);
+      }
+      worker(0);
+    }
+
+    // no two list edges sharing a vertex have the same colour
+    [[nodiscard]] bool
+    isProperEdgeColouring(std::span<const size_t> colours) const
+    {
+      std::vector<std::vector<size_t>> at(getIncidence().size());
+      for (size_t edge = 0; edge < _matrix.size(); ++edge) {
+        at[_matrix[edge]._startNode].push_back(colours[edge]);
+        if (_matrix[edge]._endNode != _matrix[edge]._startNode) {
+          at[_matrix[edge]._endNode].push_back(colours[edge]);
+        }
+      }
+      return std::ranges::all_of(at, [](std::vector<size_t>& vertex_colours) {
+        std::ranges::sort(vertex_colours);
+        return std::ranges::adjacent_find(vertex_colours) ==
+               vertex_colours.end();
+      });
+    }
+
+    void
+    deduplicateEdgesImpl(bool unordered, EdgeDedupPolicy policy)
+    {
+      std::unordered_map<std::pair<size_t, size_t>, size_t, EdgeKeyHash>
+          winners;
+      winners.reserve(_matrix.size());
+      for (size_t i = 0; i < _matrix.size(); ++i) {
+        std::pair<size_t, size_t> key{_matrix[i]._startNode,
+                                      _matrix[i]._endNode};
+        if (unordered && key.first > key.second) {
+          std::swap(key.first, key.second);
+        }
+        auto [it, inserted] = winners.try_emplace(key, i);
+        if (!inserted && policy == EdgeDedupPolicy::KeepMinWeight &&
+            _matrix[i]._value < _matrix[it->second]._value) {
+          it->second = i;
+        }
+      }
+
+      std::vector<bool> keep(_matrix.size(), false);
+      for (const auto& [key, edge] : winners) {
+        keep[edge] = true;
+      }
+      size_t kept{};
+      for (size_t i = 0; i < _matrix.size(); ++i) {
+        if (keep[i]) {
+          _matrix[kept++] = _matrix[i];
+        }
+      }
+      _matrix.resize(kept);
+      _incidence._valid = false;
+    }
+
+    // dijkstra from source to target that never enters a blocked vertex and
+    // does not leave source towards blocked_next, empty path if unreachable
+    std::pair<uint64_t, std::vector<size_t>>
+    shortestPathAvoiding(size_t source, size_t target,
+                         const std::vector<bool>& blocked,
+                         std::span<const size_t> blocked_next) const
+    {
+      using queue_entry = std::pair<uint64_t, size_t>;
+
+      std::vector<uint64_t> distances(blocked.size(), kUnreachable);
+      std::vector<size_t> parents(blocked.size(), kUnreachable);
+      std::priority_queue<queue_entry, std::vector<queue_entry>, std::greater<>>
+          queue;
+
+      distances[source] = 0;
+      queue.emplace(0, source);
+
+      while (!queue.empty()) {
+        auto [distance, current] = queue.top();
+        queue.pop();
+        if (distance != distances[current]) {
+          continue;
+        }
+        if (current == target) {
+          break;
+        }
+        forEachNeighbour(current, [&](size_t i, ValueType value) {
+          if (blocked[i] || (current == source &&
+                             std::ranges::find(blocked_next, i) !=
+                                 blocked_next.end())) {
+            return;
+          }
+          uint64_t new_value = distance + static_cast<uint64_t>(value);
+          if (new_value < distances[i]) {
+            distances[i] = new_value;
+            parents[i]   = current;
+            queue.emplace(new_value, i);
+          }
+        });
+      }
+
+      std::vector<size_t> path;
+      if (distances[target] == kUnreachable) {
+        return {kUnreachable, path};
+      }
+      for (size_t i = target; i != kUnreachable; i = parents[i]) {
+        path.push_back(i);
+      }
+      std::ranges::reverse(path);
+      return {distances[target], std::move(path)};
+    }
+
+    // cheapest of the parallel edges first_node -> second_node
+    uint64_t
+    minEdgeValue(size_t first_node, size_t second_node) const
+    {
+      uint64_t result{kUnreachable};
+      forEachNeighbour(first_node, [&result, second_node](size_t i,
+                                                          ValueType value) {
+        if (i == second_node) {
+          result = std::min(result, static_cast<uint64_t>(value));
+        }
+      });
+      return result;
+    }
+
+    static unsigned_value_type
+    toDistanceValue(uint64_t distance)
+    {
+      return static_cast<unsigned_value_type>(
+          distance == kUnreachable ? kNodeValueMax : distance);
+    }
+
+    unsigned_value_type
+    djkstra(size_t first_node_index, size_t second_node_index) const
+    {
+      prepareAdjacency();
+      return toDistanceValue(dijkstraRow(
+          first_node_index, second_node_index)[second_node_index]);
     }
 
     [[nodiscard]] bool
@@ -0,0 +1,489 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace spectral {
+  constexpr double kTolerance{1e-8};
+  constexpr size_t kMaxIterations{5000};
+  constexpr size_t kProbes{32};
+  constexpr size_t kLanczosSteps{64};
+  constexpr uint64_t kSeed{0x5eed};
+
+  // L = D - W of an undirected graph with the off-diagonal weights in csr
+  // form. Only w_ij > 0 is stored and loops are dropped, so every row sums
+  // to zero and the all-ones vector spans the kernel of a connected graph
+  struct SparseLaplacian {
+    std::vector<size_t> _offsets;
+    std::vector<size_t> _neighbours;
+    std::vector<double> _weights;
+    std::vector<double> _diagonal;
+
+    [[nodiscard]] size_t
+    size() const
+    {
+      return _diagonal.size();
+    }
+    // y = L x
+    void
+    multiply(std::span<const double> x, std::span<double> y) const
+    {
+      for (size_t i = 0; i < size(); ++i) {
+        double sum = _diagonal[i] * x[i];
+        for (size_t k = _offsets[i]; k < _offsets[i + 1]; ++k) {
+          sum -= _weights[k] * x[_neighbours[k]];
+        }
+        y[i] = sum;
+      }
+    }
+    // gershgorin bound on the largest eigenvalue
+    [[nodiscard]] double
+    normBound() const
+    {
+      double result{};
+      for (double degree : _diagonal) {
+        result = std::max(result, 2 * degree);
+      }
+      return result;
+    }
+  };
+
+  // _value is the algebraic connectivity, zero for disconnected graphs;
+  // _vector is a unit eigenvector orthogonal to the all-ones vector
+  struct FiedlerPair {
+    double _value{};
+    std::vector<double> _vector;
+    bool _converged{};
+  };
+
+  namespace detail {
+    inline double
+    dot(std::span<const double> a, std::span<const double> b)
+    {
+      return std::inner_product(a.begin(), a.end(), b.begin(), 0.0);
+    }
+    // a += factor * b
+    inline void
+    axpy(double factor, std::span<const double> b, std::span<double> a)
+    {
+      for (size_t i = 0; i < a.size(); ++i) {
+        a[i] += factor * b[i];
+      }
+    }
+    inline void
+    scale(double factor, std::span<double> a)
+    {
+      for (double& value : a) {
+        value *= factor;
+      }
+    }
+    // removes the component along the all-ones vector
+    inline void
+    centre(std::span<double> a)
+    {
+      if (a.empty()) {
+        return;
+      }
+      double mean = std::accumulate(a.begin(), a.end(), 0.0) /
+                    static_cast<double>(a.size());
+      for (double& value : a) {
+        value -= mean;
+      }
+    }
+
+    // vertexes reachable from vertex 0, all of them for a connected graph
+    inline std::vector<bool>
+    firstComponent(const SparseLaplacian& laplacian)
+    {
+      std::vector<bool> reached(laplacian.size(), false);
+      if (reached.empty()) {
+        return reached;
+      }
+      std::vector<size_t> stack{0};
+      reached[0] = true;
+      while (!stack.empty()) {
+        size_t vertex = stack.back();
+        stack.pop_back();
+        for (size_t k = laplacian._offsets[vertex];
+             k < laplacian._offsets[vertex + 1]; ++k) {
+          size_t neighbour = laplacian._neighbours[k];
+          if (!reached[neighbour]) {
+            reached[neighbour] = true;
+            stack.push_back(neighbour);
+          }
+        }
+      }
+      return reached;
+    }
+
+    // cyclic jacobi rotations on a small dense symmetric matrix stored row
+    // major. Eigenvalues go to values, eigenvector k to column k of vectors
+    inline void
+    symmetricEigen(std::vector<double> matrix, size_t size,
+                   std::vector<double>& values, std::vector<double>& vectors)
+    {
+      constexpr size_t kMaxSweeps{64};
+      vectors.assign(size * size, 0.0);
+      for (size_t i = 0; i < size; ++i) {
+        vectors[i * size + i] = 1.0;
+      }
+      auto at = [&matrix, size](size_t i, size_t j) -> double& {
+        return matrix[i * size + j];
+      };
+
+      for (size_t sweep = 0; sweep < kMaxSweeps; ++sweep) {
+        double off{};
+        double norm{};
+        for (size_t i = 0; i < size; ++i) {
+          norm += at(i, i) * at(i, i);
+          for (size_t j = i + 1; j < size; ++j) {
+            off += at(i, j) * at(i, j);
+          }
+        }
+        if (off <= std::numeric_limits<double>::epsilon() *
+                       std::numeric_limits<double>::epsilon() * norm) {
+          break;
+        }
+        for (size_t p = 0; p < size; ++p) {
+          for (size_t q = p + 1; q < size; ++q) {
+            if (at(p, q) == 0.0) {
+              continue;
+            }
+            double theta = (at(q, q) - at(p, p)) / (2 * at(p, q));
+            double t     = std::copysign(1.0, theta) /
+                       (std::abs(theta) + std::sqrt(theta * theta + 1));
+            double c = 1 / std::sqrt(t * t + 1);
+            double s = t * c;
+            for (size_t k = 0; k < size; ++k) {
+              double kp = at(k, p);
+              double kq = at(k, q);
+              at(k, p)  = c * kp - s * kq;
+              at(k, q)  = s * kp + c * kq;
+            }
+            for (size_t k = 0; k < size; ++k) {
+              double pk = at(p, k);
+              double qk = at(q, k);
+              at(p, k)  = c * pk - s * qk;
+              at(q, k)  = s * pk + c * qk;
+            }
+            for (size_t k = 0; k < size; ++k) {
+              double kp             = vectors[k * size + p];
+              double kq             = vectors[k * size + q];
+              vectors[k * size + p] = c * kp - s * kq;
+              vectors[k * size + q] = s * kp + c * kq;
+            }
+          }
+        }
+      }
+      values.resize(size);
+      for (size_t i = 0; i < size; ++i) {
+        values[i] = at(i, i);
+      }
+    }
+  }  // namespace detail
+
+  // smallest eigenpair of L on the complement of the all-ones vector by
+  // single-vector LOBPCG with a jacobi preconditioner: one product with L
+  // and a 3x3 rayleigh-ritz step per iteration, O(V) extra memory. Stops
+  // once ||Lx - λx|| is below tolerance times the gershgorin bound.
+  // Disconnected graphs are answered exactly from their first component
+  inline FiedlerPair
+  fiedlerPair(const SparseLaplacian& laplacian, double tolerance = kTolerance,
+              size_t max_iterations = kMaxIterations, uint64_t seed = kSeed)
+  {
+    size_t n = laplacian.size();
+    FiedlerPair result{};
+    result._vector.assign(n, 0.0);
+    if (n < 2) {
+      result._converged = true;
+      return result;
+    }
+
+    auto reached  = detail::firstComponent(laplacian);
+    auto in_first = static_cast<size_t>(std::ranges::count(reached, true));
+    if (in_first != n) {
+      // indicator of the first component against the rest is a null vector
+      double inside  = 1.0 / static_cast<double>(in_first);
+      double outside = -1.0 / static_cast<double>(n - in_first);
+      for (size_t i = 0; i < n; ++i) {
+        result._vector[i] = reached[i] ? inside : outside;
+      }
+      detail::scale(1 / std::sqrt(detail::dot(result._vector, result._vector)),
+                    result._vector);
+      result._converged = true;
+      return result;
+    }
+
+    constexpr size_t kBasis{3};
+    std::array<std::vector<double>, kBasis> basis;
+    std::array<std::vector<double>, kBasis> images;
+    for (size_t a = 0; a < kBasis; ++a) {
+      basis[a].assign(n, 0.0);
+      images[a].assign(n, 0.0);
+    }
+    auto& x  = basis[0];
+    auto& lx = images[0];
+
+    std::mt19937_64 gen(seed);
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    for (double& value : x) {
+      value = distribution(gen);
+    }
+    detail::centre(x);
+    detail::scale(1 / std::sqrt(detail::dot(x, x)), x);
+    laplacian.multiply(x, lx);
+
+    double bound = laplacian.normBound();
+    double theta = detail::dot(x, lx);
+    std::vector<double> residual(n);
+    std::vector<double> next_x(n);
+    std::vector<double> next_lx(n);
+    std::vector<double> small;
+    std::vector<double> values;
+    std::vector<double> vectors;
+    bool has_direction{};
+
+    for (size_t iteration = 0; iteration < max_iterations; ++iteration) {
+      for (size_t i = 0; i < n; ++i) {
+        residual[i] = lx[i] - theta * x[i];
+      }
+      if (std::sqrt(detail::dot(residual, residual)) <= tolerance * bound) {
+        result._converged = true;
+        break;
+      }
+
+      // preconditioned residual as the new search direction
+      auto& w = basis[1];
+      for (size_t i = 0; i < n; ++i) {
+        double degree = laplacian._diagonal[i];
+        w[i]          = residual[i] / (degree > 0 ? degree : 1.0);
+      }
+      detail::centre(w);
+      laplacian.multiply(w, images[1]);
+
+      // orthonormalize [x, w, p] together with their images under L,
+      // dropping directions that have become dependent
+      std::array<size_t, kBasis> order{0, 1, 2};
+      size_t rank{1};
+      for (size_t a = 1; a < (has_direction ? 3U : 2U); ++a) {
+        auto& v  = basis[a];
+        auto& lv = images[a];
+        double before = std::sqrt(detail::dot(v, v));
+        for (size_t pass = 0; pass < 2; ++pass) {
+          for (size_t b = 0; b < rank; ++b) {
+            double projection = detail::dot(basis[order[b]], v);
+            detail::axpy(-projection, basis[order[b]], v);
+            detail::axpy(-projection, images[order[b]], lv);
+          }
+        }
+        double after = std::sqrt(detail::dot(v, v));
+        if (after <= 1e-10 * before || after == 0.0) {
+          continue;
+        }
+        detail::scale(1 / after, v);
+        detail::scale(1 / after, lv);
+        order[rank++] = a;
+      }
+
+      small.assign(rank * rank, 0.0);
+      for (size_t a = 0; a < rank; ++a) {
+        for (size_t b = a; b < rank; ++b) {
+          double value = (detail::dot(basis[order[a]], images[order[b]]) +
+                          detail::dot(basis[order[b]], images[order[a]])) /
+                         2;
+          small[a * rank + b] = small[b * rank + a] = value;
+        }
+      }
+      detail::symmetricEigen(small, rank, values, vectors);
+      size_t lowest = static_cast<size_t>(
+          std::ranges::min_element(values) - values.begin());
+      theta = values[lowest];
+
+      // new x from the whole basis, new p from its w and p part
+      std::ranges::fill(next_x, 0.0);
+      std::ranges::fill(next_lx, 0.0);
+      for (size_t a = 1; a < rank; ++a) {
+        double c = vectors[a * rank + lowest];
+        detail::axpy(c, basis[order[a]], next_x);
+        detail::axpy(c, images[order[a]], next_lx);
+      }
+      has_direction = rank > 1;
+      if (has_direction) {
+        basis[2]  = next_x;
+        images[2] = next_lx;
+      }
+      double c0 = vectors[lowest];
+      detail::axpy(c0, x, next_x);
+      detail::axpy(c0, lx, next_lx);
+      std::swap(x, next_x);
+      std::swap(lx, next_lx);
+
+      // centring only removes a multiple of the kernel, lx stays as is
+      detail::centre(x);
+      double norm = std::sqrt(detail::dot(x, x));
+      detail::scale(1 / norm, x);
+      detail::scale(1 / norm, lx);
+    }
+
+    result._value  = std::max(theta, 0.0);
+    result._vector = x;
+    return result;
+  }
+
+  // ln of the number of spanning trees, or of their total weight product
+  // for weighted graphs. By kirchhoff's theorem that is ln det of L without
+  // the row and column of one vertex r, taken as the one of highest degree;
+  // scaling by D^-1/2 splits it into sum ln d_i plus ln det of the reduced
+  // normalized laplacian N, whose spectrum lies in (0, 2).
+  // ln det N = E[z^T ln(N) z] is estimated by stochastic lanczos quadrature
+  // over rademacher probes, or summed exactly over unit vectors when there
+  // are no more vertexes than probes. Costs probes * steps products with L,
+  // probes run on all hardware threads; -inf for disconnected graphs
+  inline double
+  logSpanningTrees(const SparseLaplacian& laplacian, size_t probes = kProbes,
+                   size_t steps = kLanczosSteps, uint64_t seed = kSeed)
+  {
+    size_t n = laplacian.size();
+    if (n < 2) {
+      return 0.0;
+    }
+    auto reached = detail::firstComponent(laplacian);
+    if (std::ranges::find(reached, false) != reached.end()) {
+      return -std::numeric_limits<double>::infinity();
+    }
+
+    auto removed = static_cast<size_t>(
+        std::ranges::max_element(laplacian._diagonal) -
+        laplacian._diagonal.begin());
+    std::vector<double> inverse_root(n);
+    double result{};
+    for (size_t i = 0; i < n; ++i) {
+      inverse_root[i] = 1 / std::sqrt(laplacian._diagonal[i]);
+      if (i != removed) {
+        result += std::log(laplacian._diagonal[i]);
+      }
+    }
+    std::vector<double> normalized(laplacian._weights.size());
+    for (size_t i = 0; i < n; ++i) {
+      for (size_t k = laplacian._offsets[i]; k < laplacian._offsets[i + 1];
+           ++k) {
+        normalized[k] = laplacian._weights[k] * inverse_root[i] *
+                        inverse_root[laplacian._neighbours[k]];
+      }
+    }
+    // y = N x, the removed coordinate stays zero
+    auto multiply = [&](std::span<const double> x, std::span<double> y) {
+      for (size_t i = 0; i < n; ++i) {
+        double sum = x[i];
+        for (size_t k = laplacian._offsets[i]; k < laplacian._offsets[i + 1];
+             ++k) {
+          sum -= normalized[k] * x[laplacian._neighbours[k]];
+        }
+        y[i] = sum;
+      }
+      y[removed] = 0.0;
+    };
+
+    probes     = std::max<size_t>(probes, 1);
+    bool exact = n - 1 <= probes;
+    if (exact) {
+      probes = n - 1;
+    }
+    steps = std::clamp<size_t>(steps, 1, n - 1);
+    std::vector<double> estimates(probes, 0.0);
+    std::atomic<size_t> next_probe{};
+
+    auto worker = [&]() {
+      std::vector<double> q(n);
+      std::vector<double> previous(n);
+      std::vector<double> v(n);
+      std::vector<double> alphas;
+      std::vector<double> betas;
+      std::vector<double> tridiagonal;
+      std::vector<double> values;
+      std::vector<double> vectors;
+
+      for (size_t probe = next_probe++; probe < probes;
+           probe        = next_probe++) {
+        std::ranges::fill(q, 0.0);
+        if (exact) {
+          q[probe < removed ? probe : probe + 1] = 1.0;
+        }
+        else {
+          std::mt19937_64 gen(seed + probe);
+          double norm = 1 / std::sqrt(static_cast<double>(n - 1));
+          for (size_t i = 0; i < n; ++i) {
+            q[i] = (gen() & 1U) != 0 ? norm : -norm;
+          }
+          q[removed] = 0.0;
+        }
+        std::ranges::fill(previous, 0.0);
+        alphas.clear();
+        betas.clear();
+
+        double beta{};
+        for (size_t step = 0; step < steps; ++step) {
+          multiply(q, v);
+          double alpha = detail::dot(q, v);
+          alphas.push_back(alpha);
+          for (size_t i = 0; i < n; ++i) {
+            v[i] -= alpha * q[i] + beta * previous[i];
+          }
+          beta = std::sqrt(detail::dot(v, v));
+          if (step + 1 == steps || beta <= 1e-12) {
+            break;
+          }
+          betas.push_back(beta);
+          std::swap(previous, q);
+          for (size_t i = 0; i < n; ++i) {
+            q[i] = v[i] / beta;
+          }
+        }
+
+        // gauss quadrature: ritz values as nodes, squared first components
+        // of the ritz vectors as weights
+        size_t size = alphas.size();
+        tridiagonal.assign(size * size, 0.0);
+        for (size_t i = 0; i < size; ++i) {
+          tridiagonal[i * size + i] = alphas[i];
+          if (i + 1 < size) {
+            tridiagonal[i * size + i + 1] = tridiagonal[(i + 1) * size + i] =
+                betas[i];
+          }
+        }
+        detail::symmetricEigen(tridiagonal, size, values, vectors);
+        double estimate{};
+        for (size_t k = 0; k < size; ++k) {
+          estimate += vectors[k] * vectors[k] *
+                      std::log(std::max(values[k],
+                                        std::numeric_limits<double>::min()));
+        }
+        estimates[probe] = estimate;
+      }
+    };
+
+    size_t thread_count = std::min<size_t>(
+        std::max(1U, std::thread::hardware_concurrency()), probes);
+    {
+      std::vector<std::jthread> threads;
+      for (size_t t = 1; t < thread_count; ++t) {
+        threads.emplace_back(worker);
+      }
+      worker();
+    }
+
+    double sum = std::accumulate(estimates.begin(), estimates.end(), 0.0);
+    return result + (exact ? sum
+                           : static_cast<double>(n - 1) * sum /
+                                 static_cast<double>(probes));
+  }
+}  // namespace spectral
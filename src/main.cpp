@@ -297,6 +297,7 @@ generateWS(visual::GraphRenderer& renderer)
 
   renderGraph(renderer, matrix);
 }
+*/
 static graph_first::graph_types::ResizableGraph<
     graph_first::graph_flags::kEmpty>
 generateHex(size_t M)
@@ -327,7 +328,7 @@ generateHex(size_t M)
     }
   }
 
-  std::set<size_t, std::greater<>> idxes;
+  std::vector<size_t> idxes;
   size_t c_i = 0;
   for (const auto& arr : matrix.getContainer()) {
     size_t test = 0;
@@ -337,19 +338,17 @@ generateHex(size_t M)
       }
     }
     if (test < 2) {
-      idxes.insert(c_i);
+      idxes.push_back(c_i);
     }
     c_i++;
   }
 
-  for (auto i : idxes) {
-    matrix.removeVertex(i);
-  }
+  matrix.removeVertices(idxes);
 
   return matrix;
 }
 
-static void
+void
 benchmark()
 {
   for (size_t i = 3; i < 10; ++i) {
@@ -358,9 +357,9 @@ benchmark()
     double time_elapsed{};
     constexpr size_t kBenchN{1000000};
     for (size_t j = 0; j < kBenchN; ++j) {
-      auto time     = std::chrono::steady_clock::now();
-      auto res      = matrix.getClusters({});
-      auto duration = std::chrono::duration<double>{
+      auto time                 = std::chrono::steady_clock::now();
+      [[maybe_unused]] auto res = matrix.getClusters({});
+      auto duration             = std::chrono::duration<double>{
           std::chrono::steady_clock::now() - time};
       time_elapsed += duration.count();
     }
@@ -368,7 +367,6 @@ benchmark()
     std::print("\n\n");
   }
 }
-*/
 /*
 static graph_first::Graph<graph_first::graph_types::kNodeAmountResizable, 0,
                           uint8_t, graph_first::EdgesListTag>
@@ -486,65 +484,45 @@ getRaw()
 void
 pathesSorted()
 {
+  constexpr size_t kPathsCount{16};
   auto graph1  = generateEdges3();
 
-  auto pathes  = graph1.getAllPathes(4, 5);
+  // getAllPathes used to drop repeated edges here, costs, colours and edge
+  // indexes below all have to see the same list
+  graph1.removeExternal();
+  auto pathes  = graph1.kShortestPaths(4, 5, kPathsCount);
 
   auto colours = graph1.colorEdges();
   std::println("{} - colours", colours);
-  std::vector<std::vector<size_t>> edges(pathes.size());
-  std::vector<size_t> costs(pathes.size());
 
-  std::vector<std::pair<size_t, std::vector<size_t>>> result(graph1.size());
-  auto jt = pathes.begin();
-
-  for (auto& res : result) {
-    size_t idx = static_cast<size_t>(jt - pathes.begin());
-    costs[idx] = graph1.processPath(*jt, edges[idx]);
-
-    res.first  = costs[idx];
-    res.second = std::move(edges[idx]);
-    std::advance(jt, 1);
+  std::vector<std::pair<size_t, std::vector<size_t>>> result;
+  result.reserve(pathes.size());
+  for (auto& [cost, path] : pathes) {
+    std::vector<size_t> edges;
+    graph1.processPath(path, edges);
+    result.emplace_back(cost, std::move(edges));
   }
 
-  std::ranges::sort(
-      result, [](const auto& a, const auto& b) { return a.first <= b.first; });
-
   for (auto& i : result) {
     std::println("{} - {} cost", i.second, i.first);
   }
 
-  auto random_colour_it    = result.end();
-  const auto shortest_path = result.begin();
-
-  for (auto candidate_it = result.begin(); candidate_it != result.end();
-       ++candidate_it) {
-    std::set<size_t> picked_colours;
-    bool random_colours = true;
-    for (auto edge_idx : candidate_it->second) {
-      if (picked_colours.contains(colours[edge_idx])) {
-        random_colours = false;
-        break;
-      }
-      picked_colours.insert(colours[edge_idx]);
-    }
-    if (random_colours) {
-      random_colour_it = candidate_it;
-      break;
-    }
-  }
   if (result.size() != 0) {
-    std::println("Shortest path is - {} with cost - {}", shortest_path->second,
-                 shortest_path->first);
+    std::println("Shortest path is - {} with cost - {}", result.front().second,
+                 result.front().first);
   }
-  if (random_colour_it != result.end()) {
+  auto rainbow_path = graph1.rainbowShortestPath(4, 5, colours);
+  if (rainbow_path.has_value()) {
     std::println(
         "Shortest path with all different colours is - {} with cost - {}",
-        random_colour_it->second, random_colour_it->first);
+        rainbow_path->second, rainbow_path->first);
   }
-  else {
+  else if (rainbow_path.error() == graph_first::RainbowPathError::NoPath) {
     std::println("Path with all different colours is not found");
   }
+  else {
+    std::println("Colours can't be used for a rainbow path");
+  }
 }
 void
 degreesCheck()
@@ -554,13 +532,10 @@ degreesCheck()
   uint8_t percent = 0;
   std::array<std::array<size_t, 10>, 10> mtx{};
   while (percent != 105) {
-    std::unordered_map<size_t, size_t> degrees;
-    auto result = generateGraph<10>(percent, gen, mtx).getDegreeMatrix();
-    for (size_t i = 0; i < result.size(); ++i) {
-      degrees[result[i][i]]++;
-    }
+    graph_first::DegreeHistogram degrees;
+    degrees.add(generateGraph<10>(percent, gen, mtx).getDegreeSequence());
     for (size_t i = 0; i < 10; ++i) {
-      if (degrees.contains(i)) {
+      if (degrees.count(i) != 0) {
       }
       //   }
       //    std::cout << "\n";
@@ -760,6 +735,7 @@ main()
 {
   // degreesCheck();
   //  secondPart();
+  //  benchmark();
   std::mt19937 gen(static_cast<uint64_t>(
       std::chrono::high_resolution_clock::now().time_since_epoch().count()));
 